@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace psychic_ui {
+    namespace benchmark {
+
+        struct Benchmark {
+            std::string           name;
+            std::function<void()> run;
+        };
+
+        /**
+         * Every benchmark declared with PSYCHIC_BENCHMARK
+         */
+        inline std::vector<Benchmark> &registry() {
+            static std::vector<Benchmark> benchmarks{};
+            return benchmarks;
+        }
+
+        struct Registrar {
+            Registrar(const std::string &name, std::function<void()> run) {
+                registry().push_back({name, std::move(run)});
+            }
+        };
+
+        /**
+         * Run a function a number of times, after a warm up run, and report the average duration
+         * @param label Name printed with the result
+         * @param iterations Number of timed runs
+         * @param fn Function to measure
+         * @return Average duration of a run in milliseconds
+         */
+        template<typename F>
+        double measure(const std::string &label, unsigned int iterations, F &&fn) {
+            fn();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            for (unsigned int i = 0; i < iterations; ++i) {
+                fn();
+            }
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+            double average = elapsed.count() / iterations;
+            std::cout << "    " << label << ": " << average << " ms" << std::endl;
+            return average;
+        }
+    }
+}
+
+#define PSYCHIC_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define PSYCHIC_BENCHMARK_CONCAT(a, b) PSYCHIC_BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ * Declare a benchmark, the block following the macro is its body
+ */
+#define PSYCHIC_BENCHMARK(name)                                                                                        \
+static void PSYCHIC_BENCHMARK_CONCAT(psychic_benchmark_, __LINE__)();                                                  \
+static psychic_ui::benchmark::Registrar PSYCHIC_BENCHMARK_CONCAT(psychic_benchmark_registrar_, __LINE__)(              \
+    name, &PSYCHIC_BENCHMARK_CONCAT(psychic_benchmark_, __LINE__)                                                      \
+);                                                                                                                     \
+static void PSYCHIC_BENCHMARK_CONCAT(psychic_benchmark_, __LINE__)()
@@ -0,0 +1,22 @@
+#include <iostream>
+#include <string>
+#include "benchmark.hpp"
+
+using namespace psychic_ui;
+
+/**
+ * Runs every registered benchmark, or only the ones whose name contains the first argument
+ */
+int main(int argc, char **argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    for (const auto &benchmark: benchmark::registry()) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::cout << benchmark.name << std::endl;
+        benchmark.run();
+    }
+
+    return 0;
+}
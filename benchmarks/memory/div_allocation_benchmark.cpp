@@ -0,0 +1,106 @@
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include <psychic-ui/utils/ObjectPool.hpp>
+#include <psychic-ui/utils/YogaNodePool.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+    std::atomic<std::size_t> allocationCount{0};
+}
+
+// Count every trip to the general purpose allocator, for the whole benchmark executable
+
+void *operator new(std::size_t size) {
+    ++allocationCount;
+    if (void *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+    const unsigned int rowCount  = 100;
+    const unsigned int cellCount = 99;
+
+    /**
+     * 100 rows of 99 cells, 10k divs
+     */
+    std::shared_ptr<Div> createPage(const std::shared_ptr<StyleManager> &sm) {
+        auto page = std::make_shared<Div>();
+        page->setStyleManager(sm);
+        for (unsigned int r = 0; r < rowCount; ++r) {
+            auto row = page->add<Div>();
+            row->addClassName("row");
+            for (unsigned int c = 0; c < cellCount; ++c) {
+                row->add<Div>()->addClassName("cell");
+            }
+        }
+        return page;
+    }
+
+    void report(const std::string &label, std::size_t allocations, unsigned int divs) {
+        std::cout << "    " << label << ": " << allocations << " allocations, "
+                  << static_cast<double>(allocations) / divs << " per div" << std::endl;
+    }
+}
+
+PSYCHIC_BENCHMARK("memory: building and tearing down a 10k divs page") {
+    auto sm = std::make_shared<StyleManager>();
+    sm->style(".row")->set(flexDirection, "row");
+    sm->style(".cell")->set(grow, 1);
+
+    // Cold pools have to grow
+    std::size_t  before = allocationCount;
+    auto         page   = createPage(sm);
+    const auto   divs   = page->subtreeSize();
+    report("first build", allocationCount - before, divs);
+    before = allocationCount;
+    page   = nullptr;
+    report("first teardown", allocationCount - before, divs);
+
+    const auto stats = ObjectPool::stats();
+    std::cout << "    pooled: " << stats.free << " blocks in " << stats.chunks << " chunks, "
+              << YogaNodePool::size() << " yoga nodes" << std::endl;
+
+    // Warm pools serve the divs, styles and yoga nodes
+    before = allocationCount;
+    page   = createPage(sm);
+    report("second build", allocationCount - before, divs);
+    before = allocationCount;
+    page   = nullptr;
+    report("second teardown", allocationCount - before, divs);
+
+    benchmark::measure(
+        "build and tear down", 10, [&sm]() {
+            createPage(sm);
+        }
+    );
+}
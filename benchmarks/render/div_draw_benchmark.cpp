@@ -0,0 +1,70 @@
+#ifdef WITH_HEADLESS
+
+#include <memory>
+#include <psychic-ui/applications/HeadlessApplication.hpp>
+#include <psychic-ui/Window.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int rowCount  = 100;
+    const unsigned int cellCount = 100;
+
+    /**
+     * 100 rows of 100 bordered cells, alternating rounded, complex rounded and uneven borders
+     */
+    void createGrid(const std::shared_ptr<Window> &window) {
+        auto container = window->appContainer();
+        for (unsigned int r = 0; r < rowCount; ++r) {
+            auto row = container->add<Div>();
+            row->style()->set(flexDirection, "row")->set(grow, 1);
+            for (unsigned int c = 0; c < cellCount; ++c) {
+                auto cell = row->add<Div>()->style()
+                               ->set(grow, 1)
+                               ->set(margin, 1)
+                               ->set(backgroundColor, 0xFF404040 + c)
+                               ->set(borderColor, 0xFF808080)
+                               ->set(opacity, 0.9f);
+                switch (c % 3) {
+                    case 0:
+                        cell->set(border, 1)->set(borderRadius, 3);
+                        break;
+                    case 1:
+                        cell->set(border, 1)->set(borderRadiusTopLeft, 4)->set(borderRadiusBottomRight, 2);
+                        break;
+                    default:
+                        cell->set(borderLeft, 2)->set(borderBottom, 1);
+                        break;
+                }
+            }
+        }
+    }
+}
+
+PSYCHIC_BENCHMARK("render: draw a grid of 10k bordered and rounded divs") {
+    auto application = std::make_unique<HeadlessApplication>();
+    application->init();
+
+    auto window = std::make_shared<Window>("benchmark");
+    window->setWindowSize(2000, 1500);
+    application->open(window);
+    createGrid(window);
+    application->step();
+
+    std::cout << "    " << window->subtreeSize() << " divs" << std::endl;
+
+    // Damaging the window draws every div again without restyling or laying out anything
+    benchmark::measure(
+        "full redraw", 20, [&window]() {
+            window->invalidateRender();
+            window->drawAll();
+        }
+    );
+
+    application->close(window);
+    application->shutdown();
+}
+
+#endif
@@ -0,0 +1,83 @@
+#ifdef WITH_HEADLESS
+
+#include <memory>
+#include <vector>
+#include <psychic-ui/applications/HeadlessApplication.hpp>
+#include <psychic-ui/Window.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int panelCount = 12;
+    const unsigned int rowCount   = 20;
+    const unsigned int cellCount  = 16;
+
+    /**
+     * Static panels of rounded and bordered cells, ~4k divs
+     */
+    std::vector<std::shared_ptr<Div>> createPanels(const std::shared_ptr<Window> &window) {
+        std::vector<std::shared_ptr<Div>> panels{};
+        auto container = window->appContainer();
+        container->style()->set(flexDirection, "row")->set(flexWrap, "wrap");
+        for (unsigned int p = 0; p < panelCount; ++p) {
+            auto panel = container->add<Div>();
+            panel->style()->set(width, 200)->set(height, 200)->set(padding, 2)->set(backgroundColor, 0xFF202020);
+            for (unsigned int r = 0; r < rowCount; ++r) {
+                auto row = panel->add<Div>();
+                row->style()->set(flexDirection, "row")->set(grow, 1);
+                for (unsigned int c = 0; c < cellCount; ++c) {
+                    row->add<Div>()->style()
+                       ->set(grow, 1)
+                       ->set(margin, 1)
+                       ->set(borderRadius, 2)
+                       ->set(border, 1)
+                       ->set(borderColor, 0xFF808080)
+                       ->set(backgroundColor, 0xFF404040 + c * 8);
+                }
+            }
+            panels.push_back(panel);
+        }
+        return panels;
+    }
+}
+
+PSYCHIC_BENCHMARK("render: retained static panels") {
+    auto application = std::make_unique<HeadlessApplication>();
+    application->init();
+
+    auto window = std::make_shared<Window>("benchmark");
+    window->setWindowSize(800, 600);
+    application->open(window);
+    auto panels = createPanels(window);
+    application->step();
+
+    std::cout << "    " << window->subtreeSize() << " divs" << std::endl;
+
+    // Damaging the window redraws every panel without invalidating their recordings
+    const double immediate = benchmark::measure(
+        "full redraw, immediate", 20, [&window]() {
+            window->invalidateRender();
+            window->drawAll();
+        }
+    );
+
+    for (auto &panel: panels) {
+        panel->style()->set(retained, true);
+    }
+    application->step();
+
+    const double replayed = benchmark::measure(
+        "full redraw, retained", 20, [&window]() {
+            window->invalidateRender();
+            window->drawAll();
+        }
+    );
+    std::cout << "    speedup: " << immediate / replayed << "x" << std::endl;
+
+    application->close(window);
+    application->shutdown();
+}
+
+#endif
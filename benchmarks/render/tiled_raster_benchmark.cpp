@@ -0,0 +1,49 @@
+#ifdef WITH_HEADLESS
+
+#include <memory>
+#include <string>
+#include <psychic-ui/applications/HeadlessApplication.hpp>
+#include <psychic-ui/utils/TaskPool.hpp>
+#include "example/demo/DemoWindow.hpp"
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+PSYCHIC_BENCHMARK("render: tiled rasterization of the demo window at 4K") {
+    auto application = std::make_unique<HeadlessApplication>();
+    application->init();
+
+    auto window = std::make_shared<DemoWindow>();
+    window->setWindowSize(3840, 2160);
+    application->open(window);
+    application->step();
+
+    std::cout << "    " << window->subtreeSize() << " divs, tiles of " << Window::rasterTileSize
+              << "px" << std::endl;
+
+    // Damaging the whole window records and rasterizes everything again
+    const double single = benchmark::measure(
+        "full redraw, 1 thread", 10, [&window]() {
+            window->invalidateRender();
+            window->drawAll();
+        }
+    );
+
+    for (unsigned int threads : {2u, 4u, 8u}) {
+        // The thread waiting on the tiles rasterizes too
+        window->setRasterTaskPool(std::make_shared<TaskPool>(threads - 1));
+        const double tiled = benchmark::measure(
+            "full redraw, " + std::to_string(threads) + " threads", 10, [&window]() {
+                window->invalidateRender();
+                window->drawAll();
+            }
+        );
+        std::cout << "    speedup: " << single / tiled << "x" << std::endl;
+    }
+    window->setRasterTaskPool(nullptr);
+
+    application->close(window);
+    application->shutdown();
+}
+
+#endif
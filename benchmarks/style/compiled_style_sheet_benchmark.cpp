@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <psychic-ui/style/CompiledStyleSheet.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int componentCount = 500;
+
+    /**
+     * Rules shaped like a theme, a few states and descendant rules per component
+     */
+    void declareRules(StyleManager *manager) {
+        manager->style("*")
+               ->set(fontFamily, "Ubuntu Regular")
+               ->set(fontSize, 12.0f)
+               ->set(color, 0xFFD0D0D0);
+        for (unsigned int i = 0; i < componentCount; ++i) {
+            const std::string component = ".component" + std::to_string(i);
+            manager->style(component)
+                   ->set(backgroundColor, 0xFF202020 + i)
+                   ->set(borderColor, 0xFF303030)
+                   ->set(padding, 4.0f)
+                   ->set(border, 1.0f)
+                   ->set(borderRadius, 3.0f)
+                   ->set(overflow, "hidden");
+            manager->style(component + ":hover")->set(backgroundColor, 0xFF303030);
+            manager->style(component + ":active")->set(backgroundColor, 0xFF404040);
+            manager->style(component + ":disabled")->set(opacity, 0.5f);
+            manager->style("window .panel > " + component + " .label")
+                   ->set(fontSize, 14.0f)
+                   ->set(cursor, Cursor::Hand);
+        }
+    }
+}
+
+PSYCHIC_BENCHMARK("style: loading a compiled style sheet") {
+    StyleManager authored{};
+    declareRules(&authored);
+    const std::string compiled = CompiledStyleSheet::compile(&authored, "benchmark");
+    const std::string path     = "compiled_style_sheet_benchmark.psys";
+    CompiledStyleSheet::save(compiled, path);
+
+    std::cout << "    " << componentCount * 5 + 1 << " declarations, "
+              << compiled.size() / 1024 << " KiB compiled" << std::endl;
+
+    benchmark::measure(
+        "declared with StyleManager::style", 10, []() {
+            StyleManager manager{};
+            declareRules(&manager);
+        }
+    );
+
+    benchmark::measure(
+        "loaded from compiled data", 10, [&compiled]() {
+            StyleManager manager{};
+            CompiledStyleSheet::load(&manager, compiled.data(), compiled.size(), "benchmark");
+        }
+    );
+
+    benchmark::measure(
+        "loaded from a mapped compiled file", 10, [&path]() {
+            StyleManager manager{};
+            CompiledStyleSheet::load(&manager, path, "benchmark");
+        }
+    );
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,82 @@
+#include <memory>
+#include <string>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int depth       = 32;
+    const unsigned int leavesCount = 20;
+    const unsigned int panelCount  = 20;
+
+    /**
+     * Descendant rules like an inspector theme, most of them for panels that are not in the tree
+     */
+    void createRules(StyleManager *sm) {
+        for (unsigned int i = 0; i < panelCount; ++i) {
+            const std::string panel = ".panel" + std::to_string(i);
+            sm->style(panel + " .row")->set(color, 0xFF000000 + i);
+            sm->style(panel + " .group .row")->set(paddingLeft, i);
+            sm->style(panel + " div")->set(fontSize, 10 + i);
+        }
+        sm->style(".inspector .group .row")->set(backgroundColor, 0xFFEEEEEE);
+        sm->style(".inspector .row:hover")->set(backgroundColor, 0xFFDDDDFF);
+    }
+
+    /**
+     * A chain of nested groups, every level holding a few rows
+     */
+    std::shared_ptr<Div> createTree(const std::shared_ptr<StyleManager> &sm) {
+        auto root = std::make_shared<Div>();
+        root->setStyleManager(sm);
+        root->addClassName("inspector");
+        Div *parent = root.get();
+        for (unsigned int d = 0; d < depth; ++d) {
+            auto group = parent->add<Div>();
+            group->addClassName("group");
+            for (unsigned int l = 0; l < leavesCount; ++l) {
+                parent->add<Div>()->addClassName("row");
+            }
+            parent = group.get();
+        }
+        return root;
+    }
+
+    void computeWithoutFilter(StyleManager *sm, Div *div) {
+        sm->computeStyle(div);
+        for (unsigned int i = 0; i < div->childCount(); ++i) {
+            computeWithoutFilter(sm, div->at(i));
+        }
+    }
+
+    void computeWithFilter(StyleManager *sm, Div *div, AncestorFilter &filter) {
+        sm->computeStyle(div, &filter);
+        filter.push(div);
+        for (unsigned int i = 0; i < div->childCount(); ++i) {
+            computeWithFilter(sm, div->at(i), filter);
+        }
+        filter.pop();
+    }
+}
+
+PSYCHIC_BENCHMARK("style: restyle of a 32 levels deep tree") {
+    auto sm   = std::make_shared<StyleManager>();
+    createRules(sm.get());
+    auto root = createTree(sm);
+
+    benchmark::measure(
+        "computeStyle for every div, with the ancestor filter", 10, [&root, &sm]() {
+            AncestorFilter filter{};
+            computeWithFilter(sm.get(), root.get(), filter);
+        }
+    );
+
+    benchmark::measure(
+        "computeStyle for every div, without the ancestor filter", 10, [&root, &sm]() {
+            computeWithoutFilter(sm.get(), root.get());
+        }
+    );
+}
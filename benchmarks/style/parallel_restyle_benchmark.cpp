@@ -0,0 +1,79 @@
+#include <memory>
+#include <string>
+#include <thread>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include <psychic-ui/utils/TaskPool.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int panelCount = 50;
+    const unsigned int rowCount   = 40;
+    const unsigned int cellCount  = 24;
+    const unsigned int classCount = 100;
+
+    void createRules(StyleManager *sm) {
+        sm->style("*")->set(color, 0xFF000000);
+        sm->style(".panel")->set(padding, 4);
+        sm->style(".row")->set(flexDirection, "row");
+        sm->style(".row:hover")->set(backgroundColor, 0xFFDDDDFF);
+        sm->style(".panel .row .cell")->set(grow, 1);
+        for (unsigned int i = 0; i < classCount; ++i) {
+            const std::string c = std::to_string(i);
+            sm->style(".class" + c)->set(marginTop, i % 8);
+            sm->style(".panel .class" + c)->set(color, 0xFF000000 + i);
+            sm->style(".row > .class" + c + ":hover")->set(color, 0xFFFF0000);
+        }
+    }
+
+    /**
+     * 50 panels of 40 rows of 24 cells, ~50k divs
+     */
+    std::shared_ptr<Div> createTree(const std::shared_ptr<StyleManager> &sm) {
+        auto root = std::make_shared<Div>();
+        root->setStyleManager(sm);
+        for (unsigned int p = 0; p < panelCount; ++p) {
+            auto panel = root->add<Div>();
+            panel->addClassName("panel");
+            for (unsigned int r = 0; r < rowCount; ++r) {
+                auto row = panel->add<Div>();
+                row->addClassName("row");
+                for (unsigned int c = 0; c < cellCount; ++c) {
+                    // Distinct classes so that sibling sharing doesn't hide the matching cost
+                    row->add<Div>()->addClassName("class" + std::to_string((r * cellCount + c) % classCount));
+                }
+            }
+        }
+        return root;
+    }
+}
+
+PSYCHIC_BENCHMARK("style: parallel restyle of a 50k divs tree") {
+    auto sm   = std::make_shared<StyleManager>();
+    createRules(sm.get());
+    auto root = createTree(sm);
+
+    std::cout << "    " << root->subtreeSize() << " divs, subtrees of at least "
+              << Div::parallelStyleThreshold << " divs run as tasks, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    const double sequential = benchmark::measure(
+        "updateStyleRecursive, main thread", 5, [&root]() {
+            root->updateStyleRecursive();
+        }
+    );
+
+    for (unsigned int threads : {1u, 2u, 4u, 8u}) {
+        // The thread waiting on the restyle works too
+        TaskPool     pool{threads - 1};
+        const double parallel = benchmark::measure(
+            "updateStyleRecursive(pool), " + std::to_string(threads) + " threads", 5, [&root, &pool]() {
+                root->updateStyleRecursive(pool);
+            }
+        );
+        std::cout << "    speedup: " << sequential / parallel << "x" << std::endl;
+    }
+}
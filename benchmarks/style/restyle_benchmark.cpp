@@ -0,0 +1,113 @@
+#include <memory>
+#include <string>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    /**
+     * Style manager measuring the selector matching alone, either through the
+     * declaration index or by testing every declaration, like it was done before the index
+     */
+    class MatchingStyleManager : public StyleManager {
+    public:
+        size_t declarationCount() const {
+            return _declarations.size();
+        }
+
+        size_t matchIndexed(const Div *component) const {
+            return matchingDeclarations(component).size();
+        }
+
+        size_t matchEveryDeclaration(const Div *component) const {
+            size_t matches = 0;
+            for (const auto &declaration: _declarations) {
+                if (declaration.second->selector()->matches(component)) {
+                    ++matches;
+                }
+            }
+            return matches;
+        }
+    };
+
+    const unsigned int sectionCount   = 100;
+    const unsigned int divsPerSection = 100;
+    const unsigned int classCount     = 200;
+
+    /**
+     * Rules shaped like a theme: tags, classes, pseudos, descendants and ids
+     */
+    void createRules(StyleManager *sm) {
+        sm->style("*")->set(color, 0xFF000000);
+        sm->style("div")->set(backgroundColor, 0x00000000);
+        sm->style("div:hover")->set(backgroundColor, 0x10FFFFFF);
+        sm->style(".section")->set(padding, 4);
+        sm->style(".section:first-child")->set(paddingTop, 0);
+        for (unsigned int i = 0; i < classCount; ++i) {
+            const std::string c = std::to_string(i);
+            sm->style(".class" + c)->set(marginTop, i % 8);
+            sm->style("div.class" + c + ":hover")->set(color, 0xFF000000 + i);
+            sm->style(".section .class" + c + ".selected")->set(color, 0xFFFF0000);
+            sm->style("#item" + c)->set(borderRadius, 2);
+        }
+    }
+
+    /**
+     * Sections of divs spaced with a gap like boxes
+     */
+    std::shared_ptr<Div> createTree(const std::shared_ptr<StyleManager> &shared) {
+        auto root = std::make_shared<Div>();
+        root->setStyleManager(shared);
+        for (unsigned int s = 0; s < sectionCount; ++s) {
+            auto section = root->add<Div>();
+            section->addClassName("section");
+            section->style()->set(gap, 2);
+            for (unsigned int d = 0; d < divsPerSection; ++d) {
+                auto div = section->add<Div>();
+                div->addClassName("class" + std::to_string((s * divsPerSection + d) % classCount));
+                if (d % 10 == 0) {
+                    div->setId("item" + std::to_string(d));
+                }
+            }
+        }
+        return root;
+    }
+
+    template<typename F>
+    void walk(Div *div, F &&fn) {
+        fn(div);
+        for (unsigned int i = 0; i < div->childCount(); ++i) {
+            walk(div->at(i), fn);
+        }
+    }
+}
+
+PSYCHIC_BENCHMARK("style: full restyle of a 10k divs tree") {
+    auto sm   = std::make_shared<MatchingStyleManager>();
+    createRules(sm.get());
+    auto root = createTree(sm);
+
+    std::cout << "    " << sm->declarationCount() << " declarations, "
+              << sectionCount * divsPerSection + sectionCount + 1 << " divs" << std::endl;
+
+    benchmark::measure(
+        "updateStyleRecursive", 10, [&root]() {
+            root->updateStyleRecursive();
+        }
+    );
+
+    size_t matches = 0;
+    benchmark::measure(
+        "selector matching, indexed", 10, [&root, &sm, &matches]() {
+            walk(root.get(), [&sm, &matches](const Div *div) { matches += sm->matchIndexed(div); });
+        }
+    );
+    benchmark::measure(
+        "selector matching, every declaration (previous algorithm)", 10, [&root, &sm, &matches]() {
+            walk(root.get(), [&sm, &matches](const Div *div) { matches += sm->matchEveryDeclaration(div); });
+        }
+    );
+}
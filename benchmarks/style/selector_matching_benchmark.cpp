@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/StyleSelector.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int matchCount = 1000000;
+
+    /**
+     * Compound matching on strings, the way divs stored their tags and classes before atoms
+     */
+    struct StringCompound {
+        std::string              tag;
+        std::vector<std::string> classes;
+
+        bool matches(const std::vector<std::string> &tags, const std::unordered_set<std::string> &classNames) const {
+            if (!tag.empty() && std::find(tags.cbegin(), tags.cend(), tag) == tags.cend()) {
+                return false;
+            }
+            return std::all_of(
+                classes.cbegin(), classes.cend(), [&classNames](const std::string &className) {
+                    return classNames.find(className) != classNames.cend();
+                }
+            );
+        }
+    };
+}
+
+PSYCHIC_BENCHMARK("style: StyleSelector::matches") {
+    auto div = std::make_shared<Div>();
+    div->setClassNames({"item", "selected", "odd", "row", "with-icon"});
+
+    std::vector<std::unique_ptr<StyleSelector>> selectors;
+    selectors.push_back(StyleSelector::fromSelector("div"));
+    selectors.push_back(StyleSelector::fromSelector("div.item.selected"));
+    selectors.push_back(StyleSelector::fromSelector(".row.odd"));
+    selectors.push_back(StyleSelector::fromSelector(".row.even"));
+    selectors.push_back(StyleSelector::fromSelector("button.item"));
+
+    std::vector<StringCompound> compounds{
+        {"div",    {}},
+        {"div",    {"item", "selected"}},
+        {"",       {"row", "odd"}},
+        {"",       {"row", "even"}},
+        {"button", {"item"}}
+    };
+    std::vector<std::string>        tags{"div"};
+    std::unordered_set<std::string> classNames{"item", "selected", "odd", "row", "with-icon"};
+
+    unsigned int matched = 0;
+    benchmark::measure(
+        std::to_string(matchCount) + " matches, atoms", 10, [&]() {
+            for (unsigned int i = 0; i < matchCount; ++i) {
+                matched += selectors[i % selectors.size()]->matches(div.get());
+            }
+        }
+    );
+
+    benchmark::measure(
+        std::to_string(matchCount) + " matches, strings (previous storage)", 10, [&]() {
+            for (unsigned int i = 0; i < matchCount; ++i) {
+                matched += compounds[i % compounds.size()].matches(tags, classNames);
+            }
+        }
+    );
+
+    std::cout << "    " << matched << " successful matches" << std::endl;
+}
@@ -0,0 +1,79 @@
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int rowCount  = 5000;
+    const unsigned int cellCount = 4;
+
+    void createRules(StyleManager *sm) {
+        sm->style("*")->set(color, 0xFF000000);
+        sm->style(".table")->set(flexDirection, "column");
+        sm->style(".row")->set(flexDirection, "row");
+        sm->style(".row.odd")->set(backgroundColor, 0xFFF0F0F0);
+        sm->style(".row:hover")->set(backgroundColor, 0xFFDDDDFF);
+        sm->style(".row:last-child")->set(borderBottom, 0);
+        sm->style(".cell")->set(padding, 4);
+        sm->style(".cell:first-child")->set(paddingLeft, 8);
+        sm->style(".table .row .cell")->set(grow, 1);
+    }
+
+    std::shared_ptr<Div> createTable(const std::shared_ptr<StyleManager> &sm) {
+        auto table = std::make_shared<Div>();
+        table->setStyleManager(sm);
+        table->addClassName("table");
+        for (unsigned int r = 0; r < rowCount; ++r) {
+            auto row = table->add<Div>();
+            row->addClassName("row");
+            if (r % 2 == 1) {
+                row->addClassName("odd");
+            }
+            for (unsigned int c = 0; c < cellCount; ++c) {
+                row->add<Div>()->addClassName("cell");
+            }
+        }
+        return table;
+    }
+
+    template<typename F>
+    void walk(Div *div, F &&fn) {
+        fn(div);
+        for (unsigned int i = 0; i < div->childCount(); ++i) {
+            walk(div->at(i), fn);
+        }
+    }
+}
+
+PSYCHIC_BENCHMARK("style: restyle of a 5k rows table") {
+    auto sm    = std::make_shared<StyleManager>();
+    createRules(sm.get());
+    auto table = createTable(sm);
+
+    benchmark::measure(
+        "updateStyleRecursive, sharing sibling styles", 10, [&table]() {
+            table->updateStyleRecursive();
+        }
+    );
+
+    std::unordered_set<const Style *> styles{};
+    unsigned int                      divs = 0;
+    walk(
+        table.get(), [&styles, &divs](const Div *div) {
+            styles.insert(div->computedStyle());
+            ++divs;
+        }
+    );
+    std::cout << "    " << divs << " divs, " << styles.size() << " computed style instances" << std::endl;
+
+    benchmark::measure(
+        "computeStyle for every div (no sharing)", 10, [&table, &sm]() {
+            walk(table.get(), [&sm](const Div *div) { sm->computeStyle(div); });
+        }
+    );
+}
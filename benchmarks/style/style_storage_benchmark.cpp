@@ -0,0 +1,90 @@
+#include <memory>
+#include <vector>
+#include <psychic-ui/Div.hpp>
+#include <psychic-ui/style/Style.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const unsigned int styleCount = 50000;
+
+    /**
+     * Declarations shaped like a theme: a few rules each setting a handful of properties
+     */
+    std::vector<std::unique_ptr<Style>> createDeclarations() {
+        std::vector<std::unique_ptr<Style>> declarations;
+
+        auto universal = std::make_unique<Style>();
+        universal->set(color, 0xFF000000);
+        universal->set(fontFamily, "Arial");
+        universal->set(fontSize, 13.0f);
+        universal->set(antiAlias, true);
+        declarations.push_back(std::move(universal));
+
+        auto box = std::make_unique<Style>();
+        box->set(backgroundColor, 0xFFFFFFFF);
+        box->set(borderColor, 0xFFCCCCCC);
+        box->set(padding, 4.0f);
+        box->set(border, 1.0f);
+        box->set(borderRadius, 2.0f);
+        box->set(overflow, "hidden");
+        declarations.push_back(std::move(box));
+
+        auto hover = std::make_unique<Style>();
+        hover->set(backgroundColor, 0xFFEEEEEE);
+        hover->set(cursor, Cursor::Hand);
+        declarations.push_back(std::move(hover));
+
+        return declarations;
+    }
+}
+
+PSYCHIC_BENCHMARK("style/storage") {
+    auto declarations = createDeclarations();
+    auto div          = std::make_shared<Div>();
+
+    auto inherited = std::make_unique<Style>();
+    inherited->set(color, 0xFF333333);
+    inherited->set(fontFamily, "Helvetica");
+    inherited->set(textAntiAlias, true);
+
+    auto defaultStyle = std::make_unique<Style>();
+    defaultStyle->set(width, Style::Auto);
+    defaultStyle->set(height, Style::Auto);
+
+    auto inlineStyle = std::make_unique<Style>();
+    inlineStyle->set(marginTop, 2.0f);
+
+    std::cout << "    sizeof(Style): " << sizeof(Style) << " bytes" << std::endl;
+
+    std::vector<std::unique_ptr<Style>> computed(styleCount);
+
+    // Same sequence of operations as Div::computeStyle
+    benchmark::measure(
+        "compute " + std::to_string(styleCount) + " styles", 10, [&]() {
+            for (auto &style : computed) {
+                style = std::make_unique<Style>();
+                style->overlayInheritable(inherited.get(), div.get());
+                style->overlay(defaultStyle.get());
+                for (const auto &declaration : declarations) {
+                    style->overlay(declaration.get());
+                }
+                style->overlay(inlineStyle.get());
+            }
+        }
+    );
+
+    benchmark::measure(
+        "compare " + std::to_string(styleCount) + " styles", 10, [&]() {
+            unsigned int same = 0;
+            for (unsigned int i = 1; i < computed.size(); ++i) {
+                same += *computed[i] == *computed[i - 1];
+            }
+            if (same != computed.size() - 1) {
+                std::cerr << "Computed styles should all be equal" << std::endl;
+            }
+        }
+    );
+}
@@ -0,0 +1,79 @@
+#include <string>
+#include <unicode/unistr.h>
+#include <SkPaint.h>
+#include <psychic-ui/utils/TextBox.hpp>
+#include "../benchmark.hpp"
+
+using namespace psychic_ui;
+
+namespace {
+
+    const char *paragraph =
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore "
+        "et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut "
+        "aliquip ex ea commodo consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum "
+        "dolore eu fugiat nulla pariatur. Excepteur sint occaecat cupidatat non proident, sunt in culpa qui "
+        "officia deserunt mollit anim id est laborum.\n";
+
+    /**
+     * Paragraphs of prose up to a number of characters
+     */
+    icu::UnicodeString createText(std::size_t size) {
+        std::string text{};
+        while (text.size() < size) {
+            text += paragraph;
+        }
+        text.resize(size);
+        return icu::UnicodeString::fromUTF8(text);
+    }
+
+    void benchmarkText(const std::string &name, std::size_t size, unsigned int iterations) {
+        SkPaint paint{};
+        paint.setTextSize(13.0f);
+
+        icu::UnicodeString text = createText(size);
+
+        TextBox textBox{};
+        textBox.setPaint(paint);
+        textBox.setBox(0.0f, 0.0f, 600.0f, 0.0f);
+
+        benchmark::measure(
+            name + " set text", iterations, [&]() {
+                textBox.setText(text);
+            }
+        );
+        std::cout << "    " << textBox.lineCount() << " lines" << std::endl;
+
+        // Alternate widths so that every paragraph has to be broken again, from the cached advances
+        float width = 600.0f;
+        benchmark::measure(
+            name + " calculate after a resize", iterations, [&]() {
+                width = width == 600.0f ? 599.0f : 600.0f;
+                textBox.setBox(0.0f, 0.0f, width, 0.0f);
+            }
+        );
+
+        benchmark::measure(
+            name + " calculate", iterations, [&]() {
+                textBox.calculate();
+            }
+        );
+
+        // Typing and erasing a character in the middle of the text
+        const auto middle = static_cast<unsigned int>(text.length() / 2);
+        benchmark::measure(
+            name + " edit", iterations, [&]() {
+                text.insert(static_cast<int32_t>(middle), static_cast<UChar>('x'));
+                textBox.updateText(middle, 0, 1);
+                text.remove(static_cast<int32_t>(middle), 1);
+                textBox.updateText(middle, 1, 0);
+            }
+        );
+    }
+}
+
+PSYCHIC_BENCHMARK("text/text box") {
+    benchmarkText("10 KB", 10 * 1024, 100);
+    benchmarkText("100 KB", 100 * 1024, 20);
+    benchmarkText("1 MB", 1024 * 1024, 5);
+}
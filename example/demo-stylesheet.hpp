@@ -11,10 +11,11 @@ using namespace psychic_ui;
  */
 class DemoStyleSheet : public StyleSheet {
 public:
-    void load(StyleManager *manager) override {
-
+    void loadResources(StyleManager *manager) override {
         manager->loadFont("stan0755", "fonts/stan0755.ttf");
+    }
 
+    void load(StyleManager *manager) override {
         manager->style(".demo-panel")
                ->set(padding, 24);
 
@@ -10,6 +10,11 @@ using Impl = psychic_ui::GLFWApplication;
 using Impl = psychic_ui::SDL2Application;
 #endif
 
+#ifdef USE_HEADLESS
+#include "applications/HeadlessApplication.hpp"
+using Impl = psychic_ui::HeadlessApplication;
+#endif
+
 namespace psychic_ui {
     using Application = Impl;
 }
@@ -1,9 +1,52 @@
+#include <algorithm>
 #include <memory>
 #include "ApplicationBase.hpp"
 #include "Window.hpp"
 
 namespace psychic_ui {
 
+    // APPLICATION
+
+    void ApplicationBase::wake() {}
+
+    RenderMode ApplicationBase::getRenderMode() const {
+        return _renderMode;
+    }
+
+    void ApplicationBase::setRenderMode(const RenderMode renderMode) {
+        _renderMode = renderMode;
+    }
+
+    float ApplicationBase::getMaxFrameRate() const {
+        return _maxFrameRate;
+    }
+
+    void ApplicationBase::setMaxFrameRate(const float maxFrameRate) {
+        _maxFrameRate = std::max(0.0f, maxFrameRate);
+    }
+
+    bool ApplicationBase::getVsync() const {
+        return _vsync;
+    }
+
+    void ApplicationBase::setVsync(const bool vsync) {
+        _vsync = vsync;
+    }
+
+    void ApplicationBase::frameRendered() {
+        _lastFrame = std::chrono::steady_clock::now();
+    }
+
+    double ApplicationBase::timeUntilNextFrame() const {
+        if (_maxFrameRate <= 0.0f) {
+            return 0.0;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _lastFrame;
+        return std::max(0.0, (1.0 / _maxFrameRate) - elapsed.count());
+    }
+
+    // WINDOW
+
     SystemWindow::SystemWindow(ApplicationBase *application, std::shared_ptr<Window> window) :
         _application(application),
         _window(window) {
@@ -16,6 +59,14 @@ namespace psychic_ui {
         return _window;
     }
 
+    bool SystemWindow::frameDrawn() const {
+        return _frameDrawn;
+    }
+
+    bool SystemWindow::hardwareAccelerated() const {
+        return true;
+    }
+
     int SystemWindow::getX() const {
         return _x;
     }
@@ -1,11 +1,27 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include "psychic-ui.hpp"
 
 namespace psychic_ui {
     class Window;
 
+    /**
+     * How the main loop decides when to render
+     */
+    enum class RenderMode {
+        /**
+         * Poll events and render every window on every iteration
+         */
+            Continuous,
+
+        /**
+         * Sleep until an event arrives or a window was invalidated
+         */
+            OnDemand
+    };
+
     class ApplicationBase {
     public:
         virtual void init() = 0;
@@ -13,6 +29,46 @@ namespace psychic_ui {
         virtual void open(std::shared_ptr<Window> window) = 0;
         virtual void close(std::shared_ptr<Window> window) = 0;
         virtual void shutdown() = 0;
+
+        /**
+         * Wake the main loop up from another thread
+         * Use it when a window was invalidated outside of an event handler, by a timer for example
+         */
+        virtual void wake();
+
+        RenderMode getRenderMode() const;
+        void setRenderMode(RenderMode renderMode);
+
+        /**
+         * Maximum number of frames rendered per second, 0 (the default) means no limit
+         */
+        float getMaxFrameRate() const;
+        void setMaxFrameRate(float maxFrameRate);
+
+        /**
+         * Wait for the display refresh when swapping buffers
+         * Only applies to the windows opened after it is set
+         */
+        bool getVsync() const;
+        void setVsync(bool vsync);
+
+    protected:
+        RenderMode _renderMode{RenderMode::Continuous};
+        float      _maxFrameRate{0.0f};
+        bool       _vsync{false};
+
+        std::chrono::steady_clock::time_point _lastFrame{};
+
+        /**
+         * Mark the end of a frame, for the frame rate cap
+         */
+        void frameRendered();
+
+        /**
+         * Time left until the frame rate cap lets the next frame be rendered
+         * @return Seconds to wait, 0 when the next frame can be rendered right away
+         */
+        double timeUntilNextFrame() const;
     };
 
     class SystemWindow {
@@ -25,6 +81,18 @@ namespace psychic_ui {
 
         virtual bool render() = 0;
 
+        /**
+         * Whether the last call to render drew a frame,
+         * a visible window with nothing to redraw doesn't
+         */
+        bool frameDrawn() const;
+
+        /**
+         * Whether the window renders through an OpenGL context
+         * When false, the window is rasterized in CPU memory
+         */
+        virtual bool hardwareAccelerated() const;
+
         int getX() const;
         int getY() const;
         int getWidth() const;
@@ -74,5 +142,6 @@ namespace psychic_ui {
         bool   _focused{false};
         bool   _minimized{false};
         bool   _maximized{false};
+        bool   _frameDrawn{false};
     };
 }
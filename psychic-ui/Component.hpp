@@ -18,6 +18,7 @@ namespace psychic_ui {
 
     protected:
         void draw(SkCanvas */*canvas*/) override {/*Skin Manages drawing*/}
+        bool occludes() const override { return false; }
 
         virtual void skinChanged() {}
 
@@ -1,10 +1,16 @@
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <SkPaint.h>
 #include <SkDashPathEffect.h>
+#include <SkPictureRecorder.h>
+#include <SkSurface.h>
 #include "utils/YogaUtils.hpp"
 #include "yoga/Yoga.h"
 #include "Div.hpp"
+#include "utils/LayerCache.hpp"
+#include "utils/TaskPool.hpp"
+#include "utils/YogaNodePool.hpp"
 #include "Window.hpp"
 
 
@@ -26,11 +32,11 @@ namespace psychic_ui {
 
     Div::Div() :
         Observer(),
-        _internalId(std::to_string(idCounter++)),
-        _defaultStyle(std::make_unique<Style>([this]() { invalidateStyle(); })),
-        _inlineStyle(std::make_unique<Style>([this]() { invalidateStyle(); })),
-        _computedStyle(std::make_unique<Style>()),
-        _yogaNode(YGNodeNew()) {
+        _defaultStyle(std::make_unique<Style>([this]() { invalidateOwnStyle(); })),
+        _inlineStyle(std::make_unique<Style>([this]() { invalidateOwnStyle(); })),
+        _computedStyle(makePooled<Style>()),
+        _yogaNode(YogaNodePool::acquire()) {
+        setInternalId(std::to_string(idCounter++));
         setTag("div");
 
         YGNodeSetContext(_yogaNode, this);
@@ -56,7 +62,15 @@ namespace psychic_ui {
     }
 
     Div::~Div() {
-        YGNodeFree(_yogaNode);
+        for (const auto &weakStyleManager: _ownedStyleManagers) {
+            if (auto sm = weakStyleManager.lock()) {
+                sm->release(this);
+            }
+        }
+        if (_cachedLayer) {
+            LayerCache::getInstance()->remove(this);
+        }
+        YogaNodePool::release(_yogaNode);
     }
 
     std::string Div::toString() const {
@@ -65,15 +79,15 @@ namespace psychic_ui {
             str = _parent->toString();
         }
         if (!_tags.empty()) {
-            str += " " + _tags.back();
+            str += " " + _tags.back().str();
         } else {
             str += " #ERROR_NO_TAG#";
         }
         if (!_id.empty()) {
-            str += "#" + _id;
+            str += "#" + _id.str();
         }
         for (auto &className: _classNames) {
-            str += "." + className;
+            str += "." + className.str();
         }
         return str;
     }
@@ -160,6 +174,10 @@ namespace psychic_ui {
         return (unsigned int) _children.size();
     }
 
+    unsigned int Div::subtreeSize() const {
+        return _subtreeSize;
+    }
+
     const std::vector<std::shared_ptr<Div>> Div::children() const {
         return _children;
     }
@@ -167,10 +185,24 @@ namespace psychic_ui {
     std::shared_ptr<Div> Div::add(unsigned int index, std::shared_ptr<Div> child) {
         assert(child != nullptr);
         assert(index >= 0 && index <= childCount());
+        Div *previousFirst = firstChildDiv();
+        Div *previousLast  = lastChildDiv();
         child->setParent(this);
         // Insert in "reverse" so that we can iterate front-to-back without using a reverse_iterator
         _children.insert(_children.cend() - index, child);
         YGNodeInsertChild(_yogaNode, child->_yogaNode, index);
+        for (Div *div = this; div; div = div->_parent) {
+            div->_subtreeSize += child->_subtreeSize;
+        }
+        child->invalidateRender();
+        if (_gap != 0) {
+            child->updateGapLayout();
+            // Appended after what was the last child, which now needs a gap
+            if (_children.front() == child && _children.size() > 1) {
+                _children[1]->updateGapLayout();
+            }
+        }
+        structureChanged(previousFirst, previousLast);
         return child;
     }
 
@@ -179,27 +211,117 @@ namespace psychic_ui {
         return add(childCount(), child);
     }
 
+    void Div::move(const std::shared_ptr<Div> child, unsigned int index) {
+        assert(child != nullptr);
+        assert(index < childCount());
+        auto it = std::find(_children.begin(), _children.end(), child);
+        if (it == _children.end()) {
+            return;
+        }
+        const unsigned int current = childCount() - 1 - (unsigned int) std::distance(_children.begin(), it);
+        if (current == index) {
+            return;
+        }
+
+        const std::shared_ptr<Div> previousLast  = _children.front();
+        Div                        *previousFirst = firstChildDiv();
+        child->invalidateRender();
+        _children.erase(it);
+        _children.insert(_children.cend() - index, child);
+        YGNodeRemoveChild(_yogaNode, child->_yogaNode);
+        YGNodeInsertChild(_yogaNode, child->_yogaNode, index);
+        if (_gap != 0 && _children.front() != previousLast) {
+            previousLast->updateGapLayout();
+            _children.front()->updateGapLayout();
+        }
+        structureChanged(previousFirst, previousLast.get());
+    }
+
     void Div::remove(const std::shared_ptr<Div> child) {
         assert(child != nullptr);
+        child->invalidateRender();
+        Div        *previousFirst = firstChildDiv();
+        Div        *previousLast  = lastChildDiv();
+        const bool wasLast        = !_children.empty() && _children.front() == child;
+        const auto count   = _children.size();
         _children.erase(std::remove(_children.begin(), _children.end(), child), _children.end());
+        if (_children.size() != count) {
+            for (Div *div = this; div; div = div->_parent) {
+                div->_subtreeSize -= child->_subtreeSize;
+            }
+        }
         YGNodeRemoveChild(_yogaNode, child->_yogaNode);
         child->setParent(nullptr);
+        if (_gap != 0) {
+            child->updateGapLayout();
+            if (wasLast && !_children.empty()) {
+                _children.front()->updateGapLayout();
+            }
+        }
+        structureChanged(previousFirst, previousLast);
     }
 
     void Div::remove(unsigned int index) {
         assert(index <= childCount());
         std::shared_ptr<Div> child = _children[index];
-        _children.erase(_children.cend() - index);
-        YGNodeRemoveChild(_yogaNode, child->_yogaNode);
-        child->setParent(nullptr);
+        remove(child);
     }
 
     void Div::removeAll() {
         for (auto &child: _children) {
+            child->invalidateRender();
             child->setParent(nullptr);
             YGNodeRemoveChild(_yogaNode, child->_yogaNode);
+            if (_gap != 0) {
+                child->updateGapLayout();
+            }
         }
+        const unsigned int removed = _subtreeSize - 1;
+        for (Div *div = this; div; div = div->_parent) {
+            div->_subtreeSize -= removed;
+        }
+        // The children are gone, only our own :empty state is left to update
+        const bool hadChildren = !_children.empty();
         _children.clear();
+        if (hadChildren) {
+            invalidatePseudoStyle(Pseudo::empty);
+        }
+    }
+
+    Div *Div::firstChildDiv() const {
+        // NOTE: Children are stored in reverse order
+        return _children.empty() ? nullptr : _children.back().get();
+    }
+
+    Div *Div::lastChildDiv() const {
+        // NOTE: Children are stored in reverse order
+        return _children.empty() ? nullptr : _children.front().get();
+    }
+
+    void Div::structureChanged(Div *previousFirst, Div *previousLast) {
+        // Style sharing and the targeted invalidation only look at the div that changed,
+        // the siblings that became or stopped being the first or last one have to be told
+        Div *first = firstChildDiv();
+        Div *last  = lastChildDiv();
+        if (first != previousFirst) {
+            if (previousFirst && previousFirst->_parent == this) {
+                previousFirst->invalidatePseudoStyle(Pseudo::firstChild);
+            }
+            if (first) {
+                first->invalidatePseudoStyle(Pseudo::firstChild);
+            }
+        }
+        if (last != previousLast) {
+            if (previousLast && previousLast->_parent == this) {
+                previousLast->invalidatePseudoStyle(Pseudo::lastChild);
+            }
+            if (last) {
+                last->invalidatePseudoStyle(Pseudo::lastChild);
+            }
+        }
+        if ((previousFirst == nullptr) != (first == nullptr)) {
+            invalidatePseudoStyle(Pseudo::empty);
+        }
     }
 
     int Div::childIndex(const std::shared_ptr<Div> child) const {
@@ -255,7 +377,8 @@ namespace psychic_ui {
     Div *Div::setEnabled(bool enabled) {
         if (_enabled != enabled) {
             _enabled = enabled;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::disabled);
+            invalidatePseudoStyle(Pseudo::active);
         }
         return this;
     }
@@ -284,7 +407,9 @@ namespace psychic_ui {
     void Div::setFocused(bool focused) {
         if (_focused != focused) {
             _focused = focused;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::focus);
+            // Focus can change what is drawn without changing the style (carets, selections)
+            invalidateRender();
         }
     }
 
@@ -297,7 +422,7 @@ namespace psychic_ui {
     }
 
     bool Div::boundsContains(const int x, const int y) const {
-        if (_computedStyle->get(overflow) == "visible") {
+        if (!_resolvedStyle.clips()) {
             return x >= _boundsLeft && x < _boundsRight && y >= _boundsTop && y < _boundsBottom;
         } else {
             // TODO: Keep right and bottom cached
@@ -499,18 +624,41 @@ namespace psychic_ui {
         return _inlineStyle.get();
     }
 
+    Style *Div::ownedStyle(const std::string &selector) {
+        for (const Div *div = this; div; div = div->_parent) {
+            if (div->_styleManager) {
+                const auto &sm = div->_styleManager;
+                auto registered = std::find_if(
+                    _ownedStyleManagers.cbegin(),
+                    _ownedStyleManagers.cend(),
+                    [&sm](const auto &owned) { return owned.lock() == sm; }
+                );
+                if (registered == _ownedStyleManagers.cend()) {
+                    _ownedStyleManagers.push_back(sm);
+                }
+                return sm->style(selector, this);
+            }
+        }
+        std::cerr << "No style manager for owned selector: \"" << selector << "\", returning dummy style." << std::endl;
+        return Style::dummyStyle.get();
+    }
+
     const Style *Div::computedStyle() const {
         return _computedStyle.get();
     }
 
+    const ResolvedStyle &Div::resolvedStyle() const {
+        return _resolvedStyle;
+    }
+
     Div *Div::setTag(std::string divName) {
         std::transform(divName.begin(), divName.end(), divName.begin(), ::tolower);
-        _tags.push_back(divName);
+        _tags.emplace_back(divName);
         invalidateStyle();
         return this;
     }
 
-    const std::vector<std::string> &Div::tags() const {
+    const std::vector<Atom> &Div::tags() const {
         return _tags;
     }
 
@@ -518,57 +666,86 @@ namespace psychic_ui {
         return _internalId;
     }
 
+    void Div::setInternalId(std::string internalId) {
+        // Interned here so that reading it stays safe from any thread
+        _internalIdAtom = internalId;
+        _internalId     = std::move(internalId);
+    }
+
+    const Atom &Div::internalIdAtom() const {
+        return _internalIdAtom;
+    }
+
     const std::string Div::id() const {
+        return _id.str();
+    }
+
+    const Atom &Div::idAtom() const {
         return _id;
     }
 
     Div *Div::setId(std::string id) {
         std::transform(id.begin(), id.end(), id.begin(), ::tolower);
-        if (id != _id) {
-            _id = id;
-            invalidateStyle();
+        Atom atom{id};
+        if (atom != _id) {
+            auto sm = styleManager();
+            if (sm) {
+                invalidateStyle(std::max(sm->idInvalidation(_id), sm->idInvalidation(atom)));
+            } else {
+                invalidateStyle();
+            }
+            _id = atom;
         }
         return this;
     }
 
-    const std::unordered_set<std::string> &Div::classNames() const {
+    const std::vector<Atom> &Div::classNames() const {
         return _classNames;
     }
 
+    bool Div::hasClassName(const Atom &className) const {
+        return std::binary_search(_classNames.cbegin(), _classNames.cend(), className);
+    }
+
     Div *Div::setClassNames(std::unordered_set<std::string> classNames) {
-        std::unordered_set<std::string> lcClassNames;
-        std::transform(
-            classNames.begin(), classNames.end(), std::inserter(lcClassNames, std::end(lcClassNames)),
-            [](auto className) {
-                std::string c = className;
-                std::transform(c.begin(), c.end(), c.begin(), ::tolower);
-                return c;
-            }
-        );
-        _classNames = std::move(classNames);
+        std::vector<Atom> lcClassNames;
+        lcClassNames.reserve(classNames.size());
+        for (auto className: classNames) {
+            std::transform(className.begin(), className.end(), className.begin(), ::tolower);
+            lcClassNames.emplace_back(className);
+        }
+        std::sort(lcClassNames.begin(), lcClassNames.end());
+        lcClassNames.erase(std::unique(lcClassNames.begin(), lcClassNames.end()), lcClassNames.end());
+        _classNames = std::move(lcClassNames);
         invalidateStyle();
         return this;
     }
 
     Div *Div::addClassName(std::string className) {
         std::transform(className.begin(), className.end(), className.begin(), ::tolower);
-        auto res = _classNames.insert(className);
-        if (res.second) {
-            invalidateStyle();
+        Atom atom{className};
+        auto it = std::lower_bound(_classNames.begin(), _classNames.end(), atom);
+        if (it == _classNames.end() || *it != atom) {
+            _classNames.insert(it, atom);
+            auto sm = styleManager();
+            invalidateStyle(sm ? sm->classInvalidation(atom) : StyleInvalidation::Subtree);
         }
         return this;
     }
 
     Div *Div::removeClassName(std::string className) {
         std::transform(className.begin(), className.end(), className.begin(), ::tolower);
-        auto res = _classNames.erase(className);
-        if (res) {
-            invalidateStyle();
+        Atom atom{className};
+        auto it = std::lower_bound(_classNames.begin(), _classNames.end(), atom);
+        if (it != _classNames.end() && *it == atom) {
+            _classNames.erase(it);
+            auto sm = styleManager();
+            invalidateStyle(sm ? sm->classInvalidation(atom) : StyleInvalidation::Subtree);
         }
         return this;
     }
 
-    const InheritableValues Div::inheritableValues() const {
+    const InheritableValues &Div::inheritableValues() const {
         return _inheritableValues;
     }
 
@@ -582,30 +759,231 @@ namespace psychic_ui {
     }
 
     void Div::invalidateStyle() {
-        if (_styleDirty) {
+        if (_styleDirty && _subtreeStyleDirty) {
             return;
         }
-        _styleDirty = true;
+        invalidateOwnStyle();
+        _subtreeStyleDirty = true;
+
+        if (!_children.empty()) {
+            _hasDirtyDescendants = true;
+        }
         for (const auto &child: _children) {
             child->invalidateStyle();
         }
     }
 
+    void Div::invalidateOwnStyle() {
+        if (_styleDirty) {
+            return;
+        }
+        _styleDirty = true;
+
+        // Flag the path up to us so that the style pass doesn't have to visit the whole tree
+        for (Div *ancestor = _parent; ancestor && !ancestor->_hasDirtyDescendants; ancestor = ancestor->_parent) {
+            ancestor->_hasDirtyDescendants = true;
+        }
+    }
+
+    void Div::invalidateStyle(const StyleInvalidation invalidation) {
+        switch (invalidation) {
+            case StyleInvalidation::None:
+                break;
+            case StyleInvalidation::Self:
+                invalidateOwnStyle();
+                break;
+            case StyleInvalidation::Subtree:
+                invalidateStyle();
+                break;
+        }
+    }
+
+    void Div::invalidatePseudoStyle(const Pseudo pseudo) {
+        auto sm = styleManager();
+        invalidateStyle(sm ? sm->invalidation(pseudo) : StyleInvalidation::Subtree);
+    }
+
     void Div::updateStyle() {
+        StyleSharingCandidates candidates{};
+        updateStyle(candidates, nullptr);
+    }
+
+    StyleChanges Div::updateStyle(StyleSharingCandidates &candidates, const AncestorFilter *filter) {
         if (auto sm = styleManager()) {
-            _computedStyle = sm->computeStyle(this);
+            return applyStyle(computeStyle(sm, candidates, filter));
+        }
+        return StyleChanges{};
+    }
+
+    Div::ReplacedStyle
+    Div::computeStyle(const StyleManager *sm, StyleSharingCandidates &candidates, const AncestorFilter *filter) {
+        ReplacedStyle replaced{nullptr, renderBounds()};
+        replaced.style = std::move(_computedStyle);
+
+        _computedPseudoState = StyleManager::pseudoState(this);
+        auto sibling = std::find_if(
+            candidates.cbegin(),
+            candidates.cend(),
+            [this, sm](const Div *candidate) { return candidate && sm->canShareStyle(this, candidate); }
+        );
+        if (sibling != candidates.cend()) {
+            _computedStyle = (*sibling)->_computedStyle;
+        } else {
+            // The newest candidate is a sibling restyled in this pass, after the parent
+            _computedStyle = sm->computeStyle(this, filter, candidates.front());
+            // Newest candidate first, the oldest one is dropped
+            std::move_backward(candidates.begin(), candidates.end() - 1, candidates.end());
+            candidates.front() = this;
+        }
+
+        _styleDirty        = false;
+        _subtreeStyleDirty = false;
+
+        return replaced;
+    }
+
+    StyleChanges Div::applyStyle(const ReplacedStyle &replaced) {
+        StyleChanges changes{};
+        if (_computedStyle != replaced.style) {
+            changes = _computedStyle->diff(*replaced.style);
+        }
+
+        if (!_layoutStyled || !changes.empty()) {
+            _resolvedStyle.resolve(*_computedStyle);
+        }
+
+        // Paint-only changes don't need to go through yoga
+        if (!_layoutStyled || changes.affectsLayout()) {
             updateLayout();
-            _styleDirty = false;
-            styleUpdated();
+            _layoutStyled = true;
+        }
+        styleUpdated();
+
+        // Layout changes are damaged once yoga has computed them,
+        // but a paint-only change (colors, visibility, etc.) has to be damaged here
+        if (!changes.empty()) {
+            invalidateRender(replaced.renderBounds);
+            invalidateRender();
         }
+        return changes;
+    }
+
+    bool Div::computedVisible() const {
+        return _computedStyle->has(visible) ? _computedStyle->get(visible) : _visible;
     }
 
     void Div::updateStyleRecursive() {
-        updateStyle();
+        StyleSharingCandidates candidates{};
+        AncestorFilter         filter{};
+        filter.pushAncestors(this);
+        updateStyleRecursive(candidates, filter);
+    }
+
+    void Div::updateStyleRecursive(StyleSharingCandidates &candidates, AncestorFilter &filter) {
+        updateStyle(candidates, &filter);
         if (_visible) {
+            _hasDirtyDescendants = false;
+            StyleSharingCandidates childCandidates{};
+            filter.push(this);
             for (auto &child: _children) {
-                child->updateStyleRecursive();
+                child->updateStyleRecursive(childCandidates, filter);
             }
+            filter.pop();
+        }
+    }
+
+    unsigned int Div::parallelStyleThreshold = 512;
+
+    void Div::updateStyleRecursive(TaskPool &pool) {
+        // Styles only depend on the parent's computed style and the style manager, which is only
+        // read while computing, so subtrees are computed in parallel. Everything else a restyle
+        // does (yoga, styleUpdated, damage) touches shared state and is applied in a second pass.
+        {
+            StyleSharingCandidates candidates{};
+            AncestorFilter         filter{};
+            filter.pushAncestors(this);
+            TaskGroup group{pool};
+            computeStyleRecursive(candidates, filter, group);
+            group.wait();
+        }
+        applyStyleRecursive();
+    }
+
+    void Div::computeStyleRecursive(StyleSharingCandidates &candidates, AncestorFilter &filter, TaskGroup &group) {
+        if (auto sm = styleManager()) {
+            _replacedStyle = computeStyle(sm, candidates, &filter);
+        }
+        if (!computedVisible()) {
+            return;
+        }
+
+        _hasDirtyDescendants = false;
+        StyleSharingCandidates childCandidates{};
+        filter.push(this);
+        for (auto &child: _children) {
+            if (child->_subtreeSize >= parallelStyleThreshold) {
+                // Big enough to be worth a task, it gets its own copy of the ancestors
+                // and doesn't share its style with the siblings computed here
+                Div *subtree = child.get();
+                group.run(
+                    [subtree, filter, &group]() mutable {
+                        StyleSharingCandidates subtreeCandidates{};
+                        subtree->computeStyleRecursive(subtreeCandidates, filter, group);
+                    }
+                );
+            } else {
+                child->computeStyleRecursive(childCandidates, filter, group);
+            }
+        }
+        filter.pop();
+    }
+
+    void Div::applyStyleRecursive() {
+        // Same visibility the compute pass saw, before styleUpdated applies it
+        const bool visible = computedVisible();
+        if (_replacedStyle.style) {
+            ReplacedStyle replaced = std::move(_replacedStyle);
+            _replacedStyle.style = nullptr;
+            applyStyle(replaced);
+        }
+        if (visible) {
+            for (auto &child: _children) {
+                child->applyStyleRecursive();
+            }
+        }
+    }
+
+    void Div::updateInvalidStyles() {
+        StyleSharingCandidates candidates{};
+        AncestorFilter         filter{};
+        filter.pushAncestors(this);
+        updateInvalidStyles(candidates, filter);
+    }
+
+    void Div::updateInvalidStyles(StyleSharingCandidates &candidates, AncestorFilter &filter) {
+        if (_styleDirty) {
+            const StyleChanges changes = updateStyle(candidates, &filter);
+
+            // Children that were not invalidated along with us still have to pick up the values they inherit
+            if (!changes.empty()) {
+                for (auto &child: _children) {
+                    if (changes.affectsInheritance(child->inheritableValues())) {
+                        // Flagged first so that the child doesn't flag our, already visited, ancestors
+                        _hasDirtyDescendants = true;
+                        child->invalidateOwnStyle();
+                    }
+                }
+            }
+        }
+        // Invisible divs keep their flag so that they are visited once they are visible again
+        if (_visible && _hasDirtyDescendants) {
+            _hasDirtyDescendants = false;
+            StyleSharingCandidates childCandidates{};
+            filter.push(this);
+            for (auto &child: _children) {
+                child->updateInvalidStyles(childCandidates, filter);
+            }
+            filter.pop();
         }
     }
 
@@ -684,8 +1062,21 @@ namespace psychic_ui {
         // endregion
 
         // region Background
-        _drawBackground = _computedStyle->has(backgroundColor)
-                          && (_computedStyle->get(backgroundColor) != 0x00000000);
+        _drawBackground = _resolvedStyle.backgroundColor != 0x00000000;
+        // endregion
+
+        updatePaint();
+
+        // region Gap
+        const int             previousGap       = _gap;
+        const YGFlexDirection previousDirection = _gapDirection;
+        _gap          = _computedStyle->get(gap);
+        _gapDirection = _resolvedStyle.flexDirection;
+        if (_gap != previousGap || (_gap != 0 && _gapDirection != previousDirection)) {
+            for (auto &child: _children) {
+                child->updateGapLayout();
+            }
+        }
         // endregion
     }
 
@@ -695,6 +1086,7 @@ namespace psychic_ui {
 
     void Div::invalidate() {
         YGNodeMarkDirty(_yogaNode);
+        invalidateRender();
         //std::cout << "Mark dirty" << std::endl;
     }
 
@@ -720,8 +1112,8 @@ namespace psychic_ui {
 
     // region Yoga Macros
 
-    #define YOGA_STYLE_SET(prop, conv, style, fallback) \
-        YGNodeStyleSet##prop(_yogaNode, Yoga##conv##FromString(_computedStyle->get(style), fallback)); \
+    #define YOGA_STYLE_SET_ENUM(prop, resolved) \
+        YGNodeStyleSet##prop(_yogaNode, _resolvedStyle.resolved); \
 
     #define YOGA_STYLE_SET_FLOAT_UNDEFINED(prop, style) \
         if (_computedStyle->has(style)) { \
@@ -796,16 +1188,17 @@ namespace psychic_ui {
     // endregion
 
     void Div::updateLayout() {
-        YOGA_STYLE_SET(Direction, Direction, direction, YGDirectionInherit)
-        YOGA_STYLE_SET(FlexDirection, FlexDirection, flexDirection, YGFlexDirectionColumn)
-        YOGA_STYLE_SET(JustifyContent, Justify, justifyContent, YGJustifyFlexStart)
-        YOGA_STYLE_SET(AlignContent, Align, alignContent, YGAlignFlexStart)
-        YOGA_STYLE_SET(AlignItems, Align, alignItems, YGAlignStretch)
-        YOGA_STYLE_SET(AlignSelf, Align, alignSelf, YGAlignAuto)
-        YOGA_STYLE_SET(PositionType, Position, position, YGPositionTypeRelative)
-        YOGA_STYLE_SET(FlexWrap, Wrap, flexWrap, YGWrapNoWrap)
-        YOGA_STYLE_SET(Overflow, Overflow, overflow, YGOverflowVisible)
-        YOGA_STYLE_SET(Display, Display, display, YGDisplayFlex)
+        // Strings are converted to enums once, when the style is resolved
+        YOGA_STYLE_SET_ENUM(Direction, direction)
+        YOGA_STYLE_SET_ENUM(FlexDirection, flexDirection)
+        YOGA_STYLE_SET_ENUM(JustifyContent, justifyContent)
+        YOGA_STYLE_SET_ENUM(AlignContent, alignContent)
+        YOGA_STYLE_SET_ENUM(AlignItems, alignItems)
+        YOGA_STYLE_SET_ENUM(AlignSelf, alignSelf)
+        YOGA_STYLE_SET_ENUM(PositionType, position)
+        YOGA_STYLE_SET_ENUM(FlexWrap, flexWrap)
+        YOGA_STYLE_SET_ENUM(Overflow, overflow)
+        YOGA_STYLE_SET_ENUM(Display, display)
 
         YOGA_STYLE_SET_FLOAT_UNDEFINED(Flex, flex)
         YOGA_STYLE_SET_FLOAT(FlexGrow, grow, /*kDefaultFlexGrow*/ 0.0f)
@@ -850,6 +1243,65 @@ namespace psychic_ui {
             YOGA_STYLE_SET_EDGE_FLOAT(Border, Right, borderRight)
             YOGA_STYLE_SET_EDGE_FLOAT(Border, Bottom, borderBottom)
         }
+
+        updateGapMargin();
+    }
+
+    void Div::updateGapMargin() {
+        // NOTE: Children are stored in reverse order, the last child has no gap after it
+        if (!_parent || _parent->_gap == 0 || _parent->_children.front().get() == this) {
+            return;
+        }
+
+        YGEdge                       edge;
+        std::array<FloatProperty, 3> margins;
+        std::array<FloatProperty, 3> percentMargins;
+        switch (_parent->_gapDirection) {
+            case YGFlexDirectionRow:
+                edge           = YGEdgeRight;
+                margins        = {{marginRight, marginHorizontal, margin}};
+                percentMargins = {{marginRightPercent, marginHorizontalPercent, marginPercent}};
+                break;
+            case YGFlexDirectionRowReverse:
+                edge           = YGEdgeLeft;
+                margins        = {{marginLeft, marginHorizontal, margin}};
+                percentMargins = {{marginLeftPercent, marginHorizontalPercent, marginPercent}};
+                break;
+            case YGFlexDirectionColumnReverse:
+                edge           = YGEdgeTop;
+                margins        = {{marginTop, marginVertical, margin}};
+                percentMargins = {{marginTopPercent, marginVerticalPercent, marginPercent}};
+                break;
+            case YGFlexDirectionColumn:
+            default:
+                edge           = YGEdgeBottom;
+                margins        = {{marginBottom, marginVertical, margin}};
+                percentMargins = {{marginBottomPercent, marginVerticalPercent, marginPercent}};
+                break;
+        }
+
+        // Same precedence as yoga, the gap is added to our own margin on that edge
+        float value = 0.0f;
+        for (std::size_t i = 0; i < margins.size(); ++i) {
+            if (_computedStyle->has(margins[i])) {
+                const float styleValue = _computedStyle->get(margins[i]);
+                value = std::isnan(styleValue) ? 0.0f : styleValue;
+                break;
+            }
+            if (_computedStyle->has(percentMargins[i])) {
+                // Percentages can't be added to points, the gap replaces them
+                break;
+            }
+        }
+
+        YGNodeStyleSetMargin(_yogaNode, edge, value + _parent->_gap);
+    }
+
+    void Div::updateGapLayout() {
+        // Divs that were never styled will get their gap with their first layout
+        if (_layoutStyled) {
+            updateLayout();
+        }
     }
 
     void Div::layoutUpdated() {
@@ -859,6 +1311,10 @@ namespace psychic_ui {
 
         YGNodeSetHasNewLayout(_yogaNode, false);
 
+        bool   wasLayoutReady       = layoutReady;
+        SkRect previousRect         = _rect;
+        SkRect previousRenderBounds = renderBounds();
+
         _x = (int) std::ceil(YGNodeLayoutGetLeft(_yogaNode));
         _y = (int) std::ceil(YGNodeLayoutGetTop(_yogaNode));
 
@@ -869,7 +1325,6 @@ namespace psychic_ui {
         _height = (int) std::ceil(YGNodeLayoutGetHeight(_yogaNode));
 
         _rect.set(_x, _y, _x + _width, _y + _height);
-        _roundRect.setRectRadii(_rect, _radii);
 
         _marginLeft   = YGNodeLayoutGetMargin(_yogaNode, YGEdgeLeft);
         _marginTop    = YGNodeLayoutGetMargin(_yogaNode, YGEdgeTop);
@@ -908,6 +1363,8 @@ namespace psychic_ui {
             && _borderTop == _borderBottom
         );
 
+        updatePaint();
+
 
         // Children should also update
         _boundsLeft   = _x;
@@ -927,6 +1384,13 @@ namespace psychic_ui {
 
         layoutReady = true;
 
+        if (!wasLayoutReady || previousRect != _rect || previousBoundsRect != _boundsRect) {
+            if (wasLayoutReady) {
+                invalidateRender(previousRenderBounds);
+            }
+            invalidateRender();
+        }
+
         if (previousWidth != _width || previousHeight != _height || previousBoundsRect != _boundsRect) {
             onResized(_width, _height);
         }
@@ -936,6 +1400,67 @@ namespace psychic_ui {
 
     // region Draw
 
+    void Div::invalidateRender() {
+        invalidateRender(renderBounds());
+    }
+
+    void Div::invalidateRender(const SkRect &rect) {
+        // Even when nothing is on screen, a picture replaying it would be stale once it is
+        invalidateRetainedRendering();
+
+        if (!layoutReady || rect.isEmpty()) {
+            return;
+        }
+
+        // Bring the rect into window coordinates, following what render() does to the canvas
+        SkRect damage = rect;
+        Div    *div   = this;
+        while (div->_parent) {
+            div = div->_parent;
+            if (!div->layoutReady || !div->_visible) {
+                // Nothing of us is on screen
+                return;
+            }
+            damage.offset(div->_x + div->_scrollX, div->_y + div->_scrollY);
+            if (div->_resolvedStyle.clips() && !damage.intersect(div->_rect)) {
+                return;
+            }
+        }
+
+        if (Window *w = div->window()) {
+            w->damage(damage);
+        }
+    }
+
+    SkRect Div::renderBounds() const {
+        if (_resolvedStyle.clips()) {
+            return _rect;
+        }
+        // Children are drawn scrolled, our own background and borders are not
+        SkRect bounds = _boundsRect;
+        bounds.offset(_scrollX, _scrollY);
+        bounds.join(_rect);
+        return bounds;
+    }
+
+    const sk_sp<SkPicture> &Div::retainedPicture() const {
+        return _retainedPicture;
+    }
+
+    sk_sp<SkImage> Div::layerImage() const {
+        return _cachedLayer ? LayerCache::getInstance()->find(this) : nullptr;
+    }
+
+    void Div::invalidateRetainedRendering() {
+        for (Div *div = this; div; div = div->_parent) {
+            div->_retainedPicture.reset();
+            if (div->_cachedLayer) {
+                LayerCache::getInstance()->remove(div);
+                div->_cachedLayer = false;
+            }
+        }
+    }
+
     YGSize Div::measure(float width, YGMeasureMode /*widthMode*/, float height, YGMeasureMode /*heightMode*/) {
         return YGSize{width, height};
     }
@@ -946,10 +1471,168 @@ namespace psychic_ui {
             updateStyle();
         }
 
-        if (!layoutReady || !_visible || canvas->quickReject(_rect)) {
+        // Skip whole subtrees that are outside of the damaged area
+        if (!layoutReady || !_visible || canvas->quickReject(renderBounds())) {
+            return;
+        }
+
+        if (_occludedPass != 0 && _occludedPass == renderedOcclusionPass) {
+            return;
+        }
+
+        if (_resolvedStyle.layer) {
+            renderLayer(canvas);
+            return;
+        }
+
+        if (!_resolvedStyle.retained) {
+            renderContent(canvas);
+            return;
+        }
+
+        if (!_retainedPicture) {
+            // The whole subtree is recorded, not only the damaged area, so that the picture
+            // can be replayed for any damage until something in the subtree changes
+            SkPictureRecorder  recorder;
+            const unsigned int pass = renderedOcclusionPass;
+            renderedOcclusionPass = 0;
+            renderContent(recorder.beginRecording(renderBounds()));
+            renderedOcclusionPass = pass;
+            // Restyling children while recording drops our (still empty) picture, what was
+            // recorded already includes those changes
+            _retainedPicture = recorder.finishRecordingAsPicture();
+        }
+        canvas->drawPicture(_retainedPicture);
+    }
+
+    void Div::renderLayer(SkCanvas *canvas) {
+        const SkMatrix &matrix = canvas->getTotalMatrix();
+        if (!matrix.isScaleTranslate()) {
+            // A rotated or skewed layer would be resampled, draw it as usual instead
+            renderContent(canvas);
             return;
         }
 
+        // Rasterized at the device scale so that it is composited pixel for pixel
+        const SkRect   bounds = renderBounds();
+        const SkScalar scaleX = matrix.getScaleX();
+        const SkScalar scaleY = matrix.getScaleY();
+        const SkIRect  size   = SkRect::MakeWH(bounds.width() * scaleX, bounds.height() * scaleY).roundOut();
+
+        auto           cache = LayerCache::getInstance();
+        sk_sp<SkImage> image = _cachedLayer ? cache->find(this) : nullptr;
+        if (!image || image->width() != size.width() || image->height() != size.height()) {
+            sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(size.width(), size.height());
+            if (!surface) {
+                renderContent(canvas);
+                return;
+            }
+
+            SkCanvas *layerCanvas = surface->getCanvas();
+            layerCanvas->clear(SK_ColorTRANSPARENT);
+            layerCanvas->scale(scaleX, scaleY);
+            layerCanvas->translate(-bounds.x(), -bounds.y());
+            const unsigned int pass = renderedOcclusionPass;
+            renderedOcclusionPass = 0;
+            renderContent(layerCanvas);
+            renderedOcclusionPass = pass;
+            image = surface->makeImageSnapshot();
+            // Restyling children while rasterizing drops our (still empty) layer,
+            // what was rasterized already includes those changes
+            _cachedLayer = cache->insert(this, image);
+        }
+
+        canvas->drawImageRect(
+            image,
+            SkRect::MakeXYWH(bounds.x(), bounds.y(), size.width() / scaleX, size.height() / scaleY),
+            nullptr
+        );
+    }
+
+    // region Occlusion
+
+    thread_local unsigned int Div::renderedOcclusionPass = 0;
+
+    unsigned int Div::nextOcclusionPass() {
+        static std::atomic<unsigned int> passes{0};
+        unsigned int                     pass = ++passes;
+        // 0 means no pass
+        return pass != 0 ? pass : ++passes;
+    }
+
+    bool Div::Occluders::covers(const SkIRect &rect) const {
+        return std::any_of(
+            rects.cbegin(), rects.cend(), [&rect](const SkIRect &occluder) { return occluder.contains(rect); }
+        );
+    }
+
+    void Div::Occluders::add(const SkIRect &rect) {
+        if (rect.isEmpty() || covers(rect)) {
+            return;
+        }
+        if (rects.size() < maxRects) {
+            rects.push_back(rect);
+            return;
+        }
+        auto area     = [](const SkIRect &r) { return (int64_t) r.width() * r.height(); };
+        auto smallest = std::min_element(
+            rects.begin(), rects.end(), [&area](const SkIRect &a, const SkIRect &b) { return area(a) < area(b); }
+        );
+        if (area(*smallest) < area(rect)) {
+            *smallest = rect;
+        }
+    }
+
+    bool Div::occludes() const {
+        // Only a background actually set in the style, divs without one are see-through
+        return _drawBackground
+               && _computedStyle->has(backgroundColor)
+               && !_drawRoundRect
+               && SkColorGetA(_resolvedStyle.backgroundColor) == 0xFF
+               && (!_resolvedStyle.hasOpacity || _resolvedStyle.alpha >= 255);
+    }
+
+    void Div::cullOccluded(Occluders &occluders, SkRect clip, const float x, const float y, const unsigned int pass) {
+        // Same pruning as render(), what it won't reach doesn't need to be marked
+        if (!layoutReady || !_visible) {
+            return;
+        }
+        SkRect bounds = renderBounds().makeOffset(x, y);
+        if (!bounds.intersect(clip)) {
+            return;
+        }
+        if (occluders.covers(bounds.roundOut())) {
+            _occludedPass = pass;
+            return;
+        }
+
+        const SkRect rect = _rect.makeOffset(x, y);
+
+        // Retained pictures and layers are recorded whole, their content is never culled
+        if (!_resolvedStyle.retained && !_resolvedStyle.layer) {
+            SkRect childClip = clip;
+            if (!_resolvedStyle.clips() || childClip.intersect(rect)) {
+                // Front-to-back, the first child is the last one drawn
+                for (auto &child: _children) {
+                    child->cullOccluded(occluders, childClip, x + _x + _scrollX, y + _y + _scrollY, pass);
+                }
+            }
+        }
+
+        // Our background is behind our children but in front of what was drawn before us
+        if (occludes()) {
+            SkRect  visible = rect;
+            SkIRect opaque;
+            if (visible.intersect(clip)) {
+                visible.roundIn(&opaque);
+                occluders.add(opaque);
+            }
+        }
+    }
+
+    // endregion
+
+    void Div::renderContent(SkCanvas *canvas) {
         canvas->save();
 
         draw(canvas);
@@ -1024,16 +1707,15 @@ namespace psychic_ui {
     }
 
     void Div::clip(SkCanvas *canvas) {
-        bool clip = _computedStyle->get(overflow) != "visible";
-        if (!clip) {
+        if (!_resolvedStyle.clips()) {
             return;
         }
 
-        bool aa = _computedStyle->get(antiAlias);
+        bool aa = _resolvedStyle.antiAlias;
         if (_drawRoundRect && _drawBorder) {
             SkRRect roundRect;
             // TODO: Offset for unequal borders
-            float   hb = _computedStyle->get(border) / 2;
+            float   hb = _resolvedStyle.border / 2;
             _roundRect.inset(hb, hb, &roundRect);
             canvas->clipRRect(roundRect, aa);
         } else if (_drawRoundRect) {
@@ -1043,145 +1725,102 @@ namespace psychic_ui {
         }
     }
 
-    void Div::draw(SkCanvas *canvas) {
-        // region Background & Borders
-        if (_drawBackground || _drawBorder) {
-            SkPaint paint;
-            paint.setStyle(SkPaint::kFill_Style);
-            paint.setColor(_computedStyle->get(backgroundColor));
-            paint.setAntiAlias(_computedStyle->get(antiAlias));
-            if (_computedStyle->has(opacity)) {
-                paint.setAlpha((unsigned int) (_computedStyle->get(opacity) * 255.f));
-            }
-
-            float hb = _computedStyle->get(border) / 2;
-            if (_drawComplexRoundRect) {
-                SkRRect roundRect = _roundRect;
-                if (_drawBackground && _drawBorder) {
-                    // TODO: Offset for unequal borders
-                    roundRect.inset(hb, hb);
-                }
-
-                if (_drawBackground) {
-                    canvas->drawRRect(roundRect, paint);
-                }
-
-                if (_drawBorder) {
-                    paint.setStyle(SkPaint::kStroke_Style);
-                    paint.setColor(_computedStyle->get(borderColor));
-                    paint.setStrokeWidth(_computedStyle->get(border));
-                    canvas->drawRRect(roundRect, paint);
-                }
-
-            } else if (_drawRoundRect) {
-                if (_drawBackground && !_drawBorder) {
-                    canvas->drawRoundRect(_rect, _radiusTopLeft, _radiusTopLeft, paint);
-                } else if (_drawBorder) {
-                    SkRect inset = _rect.makeInset(hb, hb);
-                    if (_drawBackground) {
-                        canvas->drawRoundRect(inset, _radiusTopLeft, _radiusTopLeft, paint);
-                    }
-                    paint.setStyle(SkPaint::kStroke_Style);
-                    paint.setColor(_computedStyle->get(borderColor));
-                    paint.setStrokeWidth(_computedStyle->get(border));
-                    canvas->drawRoundRect(inset, _radiusTopLeft, _radiusTopLeft, paint);
-                }
+    void Div::updatePaint() {
+        _roundRect.setRectRadii(_rect, _radii);
 
-            } else {
-                if (_drawBackground) {
-                    canvas->drawRect(_rect, paint);
-                }
-                if (_drawBorder && !_drawComplexBorders) {
-                    SkRect inset = _rect.makeInset(hb, hb);
-                    paint.setStyle(SkPaint::kStroke_Style);
-                    paint.setColor(_computedStyle->get(borderColor));
-                    paint.setStrokeWidth(_computedStyle->get(border));
-                    canvas->drawRect(inset, paint);
-                }
-            }
+        // region Background & Borders
+        _backgroundPaint = SkPaint{};
+        _backgroundPaint.setStyle(SkPaint::kFill_Style);
+        _backgroundPaint.setColor(_resolvedStyle.backgroundColor);
+        _backgroundPaint.setAntiAlias(_resolvedStyle.antiAlias);
+        if (_resolvedStyle.hasOpacity) {
+            _backgroundPaint.setAlpha(_resolvedStyle.alpha);
+        }
+
+        // Setting the color replaces the opacity, borders are drawn opaque
+        _borderPaint = _backgroundPaint;
+        _borderPaint.setStyle(SkPaint::kStroke_Style);
+        _borderPaint.setColor(_resolvedStyle.borderColor);
+        _borderPaint.setStrokeWidth(_resolvedStyle.border);
+
+        float hb = _resolvedStyle.border / 2;
+        _borderRect = _rect.makeInset(hb, hb);
+        if (_drawComplexRoundRect) {
+            SkRRect inset = _roundRect;
+            inset.inset(hb, hb);
+            _backgroundRoundRect = _drawBorder ? inset : _roundRect;
+            _borderRoundRect     = _drawBackground ? inset : _roundRect;
+        } else if (_drawRoundRect) {
+            _backgroundRoundRect = SkRRect::MakeRectXY(
+                _drawBorder ? _borderRect : _rect, _radiusTopLeft, _radiusTopLeft
+            );
+            _borderRoundRect     = SkRRect::MakeRectXY(_borderRect, _radiusTopLeft, _radiusTopLeft);
         }
         // endregion
-        // region Individual Borders
 
-        // TODO: Optimize
+        // region Individual Borders
+        _borderLines.clear();
         if (_drawComplexBorders && !_drawRoundRect) {
-            SkPaint paint;
-            paint.setAntiAlias(false);
-            paint.setStyle(SkPaint::kStroke_Style);
-
-            if (_borderLeft > 0) {
-                bool draw = true;
-                paint.setStrokeWidth(_borderLeft);
-                if (_computedStyle->has(borderLeftColor)) {
-                    paint.setColor(_computedStyle->get(borderLeftColor));
-                } else if (_computedStyle->has(borderHorizontalColor)) {
-                    paint.setColor(_computedStyle->get(borderHorizontalColor));
-                } else if (_computedStyle->has(borderColor)) {
-                    paint.setColor(_computedStyle->get(borderColor));
-                } else {
-                    draw = false;
-                }
-                if (draw) {
-                    float hw = _borderLeft / 2.0f;
-                    canvas->drawLine(hw, -0.5f, hw, _rect.bottom() + 0.5f, paint);
-                }
-            }
-
-            if (_borderRight > 0) {
-                bool draw = true;
-                paint.setStrokeWidth(_borderRight);
-                if (_computedStyle->has(borderRightColor)) {
-                    paint.setColor(_computedStyle->get(borderRightColor));
-                } else if (_computedStyle->has(borderHorizontalColor)) {
-                    paint.setColor(_computedStyle->get(borderHorizontalColor));
-                } else if (_computedStyle->has(borderColor)) {
-                    paint.setColor(_computedStyle->get(borderColor));
-                } else {
-                    draw = false;
-                }
-                if (draw) {
-                    float hw = _borderRight / 2.0f;
-                    canvas->drawLine(_rect.right() - hw, -0.5f, _rect.right() - hw, _rect.bottom() + 0.5f, paint);
+            auto addLine = [this](float width, Color color, SkPoint from, SkPoint to) {
+                // Transparent when no border color is set
+                if (width <= 0 || SkColorGetA(color) == 0) {
+                    return;
                 }
-            }
+                SkPaint paint;
+                paint.setAntiAlias(false);
+                paint.setStyle(SkPaint::kStroke_Style);
+                paint.setStrokeWidth(width);
+                paint.setColor(color);
+                _borderLines.push_back(BorderLine{from, to, paint});
+            };
+
+            const float l = _rect.left();
+            const float t = _rect.top();
+            const float r = _rect.right();
+            const float b = _rect.bottom();
+            addLine(
+                _borderLeft, _resolvedStyle.borderLeftColor,
+                {l + _borderLeft / 2.0f, t - 0.5f}, {l + _borderLeft / 2.0f, b + 0.5f}
+            );
+            addLine(
+                _borderRight, _resolvedStyle.borderRightColor,
+                {r - _borderRight / 2.0f, t - 0.5f}, {r - _borderRight / 2.0f, b + 0.5f}
+            );
+            addLine(
+                _borderTop, _resolvedStyle.borderTopColor,
+                {l - 0.5f, t + _borderTop / 2.0f}, {r + 0.5f, t + _borderTop / 2.0f}
+            );
+            addLine(
+                _borderBottom, _resolvedStyle.borderBottomColor,
+                {l - 0.5f, b - _borderBottom / 2.0f}, {r + 0.5f, b - _borderBottom / 2.0f}
+            );
+        }
+        // endregion
+    }
 
-            if (_borderTop > 0) {
-                bool draw = true;
-                paint.setStrokeWidth(_borderTop);
-                if (_computedStyle->has(borderTopColor)) {
-                    paint.setColor(_computedStyle->get(borderTopColor));
-                } else if (_computedStyle->has(borderVerticalColor)) {
-                    paint.setColor(_computedStyle->get(borderVerticalColor));
-                } else if (_computedStyle->has(borderColor)) {
-                    paint.setColor(_computedStyle->get(borderColor));
-                } else {
-                    draw = false;
-                }
-                if (draw) {
-                    float hw = _borderTop / 2.0f;
-                    canvas->drawLine(-0.5f, hw, _rect.right() + 0.5f, hw, paint);
-                }
+    void Div::draw(SkCanvas *canvas) {
+        // region Background & Borders
+        if (_drawBackground) {
+            if (_drawRoundRect) {
+                canvas->drawRRect(_backgroundRoundRect, _backgroundPaint);
+            } else {
+                canvas->drawRect(_rect, _backgroundPaint);
             }
+        }
 
-            if (_borderBottom > 0) {
-                bool draw = true;
-                paint.setStrokeWidth(_borderBottom);
-                if (_computedStyle->has(borderBottomColor)) {
-                    paint.setColor(_computedStyle->get(borderBottomColor));
-                } else if (_computedStyle->has(borderVerticalColor)) {
-                    paint.setColor(_computedStyle->get(borderVerticalColor));
-                } else if (_computedStyle->has(borderColor)) {
-                    paint.setColor(_computedStyle->get(borderColor));
-                } else {
-                    draw = false;
-                }
-                if (draw) {
-                    float hw = _borderBottom / 2.0f;
-                    canvas->drawLine(-0.5f, _rect.bottom() - hw, _rect.right() + 0.5f, _rect.bottom() - hw, paint);
-                }
+        if (_drawBorder) {
+            if (_drawRoundRect) {
+                canvas->drawRRect(_borderRoundRect, _borderPaint);
+            } else if (!_drawComplexBorders) {
+                canvas->drawRect(_borderRect, _borderPaint);
             }
         }
+        // endregion
 
+        // region Individual Borders
+        for (const auto &line: _borderLines) {
+            canvas->drawLine(line.from.fX, line.from.fY, line.to.fX, line.to.fY, line.paint);
+        }
         // endregion
     }
 
@@ -1216,7 +1855,7 @@ namespace psychic_ui {
     void Div::setMouseOver(bool over) {
         if (_mouseOver != over) {
             _mouseOver = over;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::hover);
         }
     }
 
@@ -1227,7 +1866,7 @@ namespace psychic_ui {
     void Div::setMouseDown(bool down) {
         if (down != _mouseDown) {
             _mouseDown = down;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::active);
         }
     }
 
@@ -1493,6 +2132,8 @@ namespace psychic_ui {
     void Div::scroll(const double scrollX, const double scrollY) {
         bool scrolled = false;
 
+        SkRect previousRenderBounds = renderBounds();
+
         if (_width < _boundsRight - _boundsLeft) {
             int sx = std::min(
                 0, std::max(
@@ -1500,7 +2141,7 @@ namespace psychic_ui {
                     _scrollX + (int) std::ceil(scrollX) * 2
                 ));
 
-            scrolled = _scrollX != sx;
+            scrolled = scrolled || _scrollX != sx;
             _scrollX = sx;
         }
 
@@ -1511,11 +2152,13 @@ namespace psychic_ui {
                     _scrollY + (int) std::ceil(scrollY) * 2
                 ));
 
-            scrolled = _scrollY != sy;
+            scrolled = scrolled || _scrollY != sy;
             _scrollY = sy;
         }
 
         if (scrolled) {
+            invalidateRender(previousRenderBounds);
+            invalidateRender();
             onScrolled(_scrollX, _scrollY);
         }
     }
@@ -1544,7 +2187,7 @@ namespace psychic_ui {
             ret = Handled;
         }
 
-        if (ret != Handled && _computedStyle->get(overflow) == "scroll") {
+        if (ret != Handled && _resolvedStyle.overflow == YGOverflowScroll) {
             // TODO: Cancel if already handled, we can't scroll two divs at the same time
             scroll(scrollX, scrollY);
         }
@@ -2,14 +2,20 @@
 
 #include <iostream>
 
+#include <array>
+#include <atomic>
 #include <vector>
 #include <unordered_set>
 #include <yoga/Yoga.h>
 #include <unicode/unistr.h>
 #include <SkCanvas.h>
+#include <SkPicture.h>
 #include <SkRRect.h>
 #include "psychic-ui.hpp"
+#include "psychic-ui/utils/Atom.hpp"
+#include "psychic-ui/utils/ObjectPool.hpp"
 #include "psychic-ui/style/Style.hpp"
+#include "psychic-ui/style/ResolvedStyle.hpp"
 #include "psychic-ui/style/StyleManager.hpp"
 #include "psychic-ui/signals/Signal.hpp"
 #include "psychic-ui/signals/Observer.hpp"
@@ -20,6 +26,10 @@ namespace psychic_ui {
 
     class Panel;
 
+    class TaskPool;
+
+    class TaskGroup;
+
     /**
      * Return status of the mouse event methods
      */
@@ -131,6 +141,12 @@ namespace psychic_ui {
          */
         unsigned int childCount() const;
 
+        /**
+         * Get the number of divs in this subtree, including this one
+         * @return Number of divs
+         */
+        unsigned int subtreeSize() const;
+
         /**
          * Get the children of this Div
          * @return Vector of child Divs
@@ -154,6 +170,7 @@ namespace psychic_ui {
 
         /**
          * Construct a child from type T and add it at the same time
+         * The child is allocated from the object pools
          * @tparam T Type of the child to add
          * @tparam Args
          * @param args Arguments to pass to the child's constructor
@@ -161,9 +178,17 @@ namespace psychic_ui {
          */
         template<typename T, typename... Args>
         std::shared_ptr<T> add(Args &&... args) {
-            return std::static_pointer_cast<T>(add(std::make_shared<T>(std::forward<Args>(args)...)));
+            return std::static_pointer_cast<T>(add(makePooled<T>(std::forward<Args>(args)...)));
         }
 
+        /**
+         * Move a child to another index, without removing it from the hierarchy
+         * so that it keeps its state (focus, scroll, styles...)
+         * @param child Child to move
+         * @param index New index of the child
+         */
+        void move(std::shared_ptr<Div> child, unsigned int index);
+
         /**
          * Remove a child by index
          * @param index Index of the child to remove
@@ -304,7 +329,9 @@ namespace psychic_ui {
 
         Div *setScrollX(const int &scrollX) {
             if (scrollX != _scrollX) {
+                invalidateRender();
                 _scrollX = scrollX;
+                invalidateRender();
                 onScrolled(_scrollX, _scrollY);
             }
             return this;
@@ -316,7 +343,9 @@ namespace psychic_ui {
 
         Div *setScrollY(const int &scrollY) {
             if (scrollY != _scrollY) {
+                invalidateRender();
                 _scrollY = scrollY;
+                invalidateRender();
                 onScrolled(_scrollX, _scrollY);
             }
             return this;
@@ -331,6 +360,13 @@ namespace psychic_ui {
 
         Signal<int, int> onResized{};
 
+        /**
+         * Whether the div was laid out at least once
+         */
+        bool isLayoutReady() const {
+            return layoutReady;
+        }
+
         #ifdef DEBUG_LAYOUT
         static bool debugLayout;
         bool        dashed{false};
@@ -346,6 +382,15 @@ namespace psychic_ui {
          */
         Style *style() const;
 
+        /**
+         * Get the style of a declaration owned by this div in the current style manager
+         * The declaration is retired when this div is destroyed, use it from createStyles
+         * for rules targeting this instance instead of adding them to the stylesheet for good.
+         * @param selector
+         * @return Style*
+         */
+        Style *ownedStyle(const std::string &selector);
+
         /**
          * Get the current style manager
          * In order of importance, the local override, the parent's (until window) or the singleton
@@ -364,27 +409,99 @@ namespace psychic_ui {
         void updateStyle();
         void updateStyleRecursive();
 
+        /**
+         * Compute style for this component and its subtree, subtrees are computed in parallel
+         * Has the same result as updateStyleRecursive(), the style manager must not be modified
+         * while it runs.
+         * @param pool Pool running the subtrees
+         */
+        void updateStyleRecursive(TaskPool &pool);
+
+        /**
+         * Minimum size of a subtree for the parallel restyle to compute it as a separate task
+         */
+        static unsigned int parallelStyleThreshold;
+
+        /**
+         * Compute style only for the dirty divs of this subtree
+         * Follows the dirty descendants flags instead of visiting every child
+         */
+        void updateInvalidStyles();
+
         /**
          * Get the computed style
          * @return
          */
         const Style *computedStyle() const;
 
-        const std::vector<std::string> &tags() const;
+        /**
+         * Get the values of the computed style used when rendering and laying out
+         * @return
+         */
+        const ResolvedStyle &resolvedStyle() const;
+
+        const std::vector<Atom> &tags() const;
+
+        /**
+         * Internal id, unique to this div
+         * Use it to build selectors targeting this div, "#" + internalId()
+         */
         const std::string internalId() const;
+
+        /**
+         * Atom of the internal id
+         */
+        const Atom &internalIdAtom() const;
+
         const std::string id() const;
+        const Atom &idAtom() const;
         Div *setId(std::string id);
-        const std::unordered_set<std::string> &classNames() const;
+
+        /**
+         * Class names, sorted by atom
+         */
+        const std::vector<Atom> &classNames() const;
+        bool hasClassName(const Atom &className) const;
         Div *setClassNames(std::unordered_set<std::string> additionalClassNames);
         Div *addClassName(std::string className);
         Div *removeClassName(std::string className);
-        virtual const InheritableValues inheritableValues() const;
+        virtual const InheritableValues &inheritableValues() const;
 
         // endregion
 
         // region Rendering
 
+        /**
+         * Mark the area covered by this div and its children as needing to be redrawn
+         */
+        void invalidateRender();
+
+        /**
+         * Mark an area as needing to be redrawn
+         * @param rect Area in the same coordinate space as this div's rect, its parent's content
+         */
+        void invalidateRender(const SkRect &rect);
 
+        /**
+         * Area this div and its children can draw into
+         * @return Rect in the same coordinate space as this div's rect, its parent's content
+         */
+        SkRect renderBounds() const;
+
+        /**
+         * Recording of this div and its children replayed by render() when the `retained` style
+         * property is set, nullptr until the next render after anything in the subtree changed
+         * @return
+         */
+        const sk_sp<SkPicture> &retainedPicture() const;
+
+        /**
+         * Image of this div and its children composited by render() when the `layer` style
+         * property is set, nullptr until the next render after anything in the subtree changed
+         * or once evicted from the LayerCache
+         * @return
+         */
+        sk_sp<SkImage> layerImage() const;
 
         // endregion
 
@@ -484,6 +601,11 @@ namespace psychic_ui {
         Div                               *_parent{nullptr};
         std::vector<std::shared_ptr<Div>> _children{};
 
+        /**
+         * Number of divs in this subtree, including this one
+         */
+        unsigned int _subtreeSize{1};
+
         // endregion
 
         // region Style
@@ -499,29 +621,41 @@ namespace psychic_ui {
         /**
          * Chain of tags from the inheritance chain
          */
-        std::vector<std::string> _tags{};
+        std::vector<Atom> _tags{};
 
         /**
          * Internal Id
          */
         static int  idCounter;
         std::string _internalId{};
+        Atom        _internalIdAtom{};
+
+        /**
+         * Set the internal id and its atom, only called on construction
+         * @param internalId
+         */
+        void setInternalId(std::string internalId);
 
         /**
          * Id
          */
-        std::string _id{};
+        Atom _id{};
 
         /**
-         * Pseudo CSS class names
+         * Pseudo CSS class names, kept sorted
          */
-        std::unordered_set<std::string> _classNames{};
+        std::vector<Atom> _classNames{};
 
         /**
          * Style Manager Override
          */
         std::shared_ptr<StyleManager> _styleManager{nullptr};
 
+        /**
+         * Style managers holding declarations owned by this div, released on destruction
+         */
+        std::vector<std::weak_ptr<StyleManager>> _ownedStyleManagers{};
+
         /**
          * Default Style
          * Use this instead of the inline style when a component needs a specific default for it to work correctly
@@ -538,20 +672,124 @@ namespace psychic_ui {
         /**
          * Computed Style
          * Computed style values, use this to obtain the final style to be applied
+         * Immutable once computed, siblings matching the same declarations share the same instance
          */
-        std::unique_ptr<Style> _computedStyle{nullptr};
+        std::shared_ptr<const Style> _computedStyle{nullptr};
+
+        /**
+         * Resolved Style
+         * Typed values of the computed style, resolved whenever the computed style changes
+         */
+        ResolvedStyle _resolvedStyle{};
+
+        /**
+         * Pseudo class state the computed style was computed with
+         * @see StyleManager::pseudoState
+         */
+        unsigned int _computedPseudoState{0};
 
         /**
          * Dirty style flag
          */
         bool _styleDirty{true};
 
+        /**
+         * Set when the style of the whole subtree was invalidated along with ours
+         */
+        bool _subtreeStyleDirty{false};
+
+        /**
+         * Set when a div somewhere under this one has a dirty style
+         */
+        bool _hasDirtyDescendants{false};
+
+        /**
+         * Siblings that computed their style last in the current style pass, most recent first
+         * The next siblings reuse their computed style when they would compute the same one
+         */
+        using StyleSharingCandidates = std::array<const Div *, 4>;
+
+        /**
+         * Style pass over the subtree
+         * The filter holds the ancestors of the div being styled, it is pushed and popped while walking down
+         * updateStyle returns what changed in the computed style
+         */
+        StyleChanges updateStyle(StyleSharingCandidates &candidates, const AncestorFilter *filter);
+
+        /**
+         * Computed style replaced by a restyle, and our render bounds with it
+         */
+        struct ReplacedStyle {
+            std::shared_ptr<const Style> style{};
+            SkRect                       renderBounds{};
+        };
+
+        /**
+         * The two halves of updateStyle
+         * computeStyle only writes to this div and only reads the parents, the siblings
+         * in candidates and the style manager, so that subtrees can be computed in parallel.
+         * applyStyle does everything else (layout, styleUpdated, damage) and has to run on the main thread.
+         */
+        ReplacedStyle computeStyle(const StyleManager *sm, StyleSharingCandidates &candidates, const AncestorFilter *filter);
+        StyleChanges applyStyle(const ReplacedStyle &replaced);
+
+        /**
+         * Visibility from the computed style, before styleUpdated applies it
+         */
+        bool computedVisible() const;
 
         /**
-         * Invalidate the style
+         * Passes of the parallel restyle
+         * The computed styles waiting to be applied are kept in _replacedStyle in between
+         */
+        void computeStyleRecursive(StyleSharingCandidates &candidates, AncestorFilter &filter, TaskGroup &group);
+        void applyStyleRecursive();
+        ReplacedStyle _replacedStyle{};
+        void updateStyleRecursive(StyleSharingCandidates &candidates, AncestorFilter &filter);
+        void updateInvalidStyles(StyleSharingCandidates &candidates, AncestorFilter &filter);
+
+        /**
+         * Invalidate the style of this div and of its whole subtree
          */
         void invalidateStyle();
 
+        /**
+         * Invalidate the style of this div only
+         * The children are restyled by the style pass if the values they inherit change
+         */
+        void invalidateOwnStyle();
+
+        /**
+         * Invalidate only what needs to be restyled
+         * @see StyleManager::invalidation
+         */
+        void invalidateStyle(StyleInvalidation invalidation);
+
+        /**
+         * Invalidate the style after a pseudo class state changed
+         * Falls back to invalidating the whole subtree when there is no style manager yet
+         * @param pseudo
+         */
+        void invalidatePseudoStyle(Pseudo pseudo);
+
+        /**
+         * First child in layout order, nullptr without children
+         */
+        Div *firstChildDiv() const;
+
+        /**
+         * Last child in layout order, nullptr without children
+         */
+        Div *lastChildDiv() const;
+
+        /**
+         * Invalidate the structural pseudo classes (:first-child, :last-child, :empty)
+         * after children were added, removed or moved
+         * @param previousFirst First child before the change
+         * @param previousLast Last child before the change
+         */
+        void structureChanged(Div *previousFirst, Div *previousLast);
+
         /**
          * Update the runtime style rules
          */
@@ -562,6 +800,7 @@ namespace psychic_ui {
          * This is called by updateRuntimeStyles and has to be overridden by div's
          * that want to add rules to the stylesheet. It will be called during the app's
          * lifetime when adding to render list or if a stylesheet is loaded.
+         * Rules only meant for this instance should be declared with ownedStyle.
          */
         virtual void createStyles() {};
 
@@ -615,6 +854,31 @@ namespace psychic_ui {
          */
         bool _ignoreInternalLayoutContraints{false};
 
+        /**
+         * Space between the children along the main axis, from the gap style
+         * It is added to the trailing margin of every child but the last one
+         */
+        int             _gap{0};
+        YGFlexDirection _gapDirection{YGFlexDirectionColumn};
+
+        /**
+         * Add the parent's gap to the yoga margin after this div
+         * Called at the end of updateLayout
+         */
+        void updateGapMargin();
+
+        /**
+         * Push the layout again after the gap around this div changed
+         * (the parent's gap or direction changed, or this div stopped or started being the last child)
+         */
+        void updateGapLayout();
+
+        /**
+         * Whether a computed style was pushed to the yoga node yet
+         * After that only the computed styles with layout changes are pushed again
+         */
+        bool _layoutStyled{false};
+
         /**
          * Sets the component as measurable
          * Registeres the measure callback
@@ -643,6 +907,83 @@ namespace psychic_ui {
         bool isValid() const;
         virtual YGSize measure(float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode);
         virtual void render(SkCanvas *canvas);
+
+        /**
+         * Draw this div and its children, what render() does once the div is known to be visible
+         * @param canvas
+         */
+        void renderContent(SkCanvas *canvas);
+
+        /**
+         * Rasterize this div and its children in a cached layer and composite it
+         * @param canvas
+         */
+        void renderLayer(SkCanvas *canvas);
+
+        /**
+         * Drop the retained pictures and layers of this div and of its ancestors,
+         * they all replay something that changed
+         */
+        void invalidateRetainedRendering();
+
+        sk_sp<SkPicture> _retainedPicture{nullptr};
+
+        /**
+         * Whether the LayerCache may hold a layer of this div, it can have been evicted since
+         */
+        bool _cachedLayer{false};
+
+        // region Occlusion
+
+        /**
+         * Opaque rects found by an occlusion pass, in window coordinates
+         * Only the largest few are kept, a single rect covering a whole subtree (modal, opaque
+         * panel) is what matters, not the union of many small ones.
+         */
+        struct Occluders {
+            static const std::size_t maxRects = 8;
+            std::vector<SkIRect>     rects{};
+
+            bool covers(const SkIRect &rect) const;
+            void add(const SkIRect &rect);
+        };
+
+        /**
+         * Front-to-back occlusion pass, marks the subtrees entirely hidden behind opaque divs
+         * drawn over them so that render() skips them
+         * @param occluders Opaque rects in front of this div, receives the rects of this subtree
+         * @param clip Area that will be drawn, in window coordinates
+         * @param x Position of the parent's content in window coordinates
+         * @param y Position of the parent's content in window coordinates
+         * @param pass Occlusion pass, see renderedOcclusionPass
+         */
+        void cullOccluded(Occluders &occluders, SkRect clip, float x, float y, unsigned int pass);
+
+        /**
+         * Whether draw() covers the whole rect with opaque pixels
+         * Divs drawing something else than the default background have to return false
+         */
+        virtual bool occludes() const;
+
+        /**
+         * Occlusion pass during which this div was found hidden
+         */
+        unsigned int _occludedPass{0};
+
+        /**
+         * Occlusion pass of the frame being rendered on this thread, 0 when there is none,
+         * like while recording retained pictures and layers which have to include everything
+         */
+        static thread_local unsigned int renderedOcclusionPass;
+
+        /**
+         * Start a new occlusion pass
+         * @return Pass id, never 0
+         */
+        static unsigned int nextOcclusionPass();
+
+        // endregion
+
         void clip(SkCanvas *canvas);
         virtual void draw(SkCanvas *canvas);
 
@@ -652,6 +993,29 @@ namespace psychic_ui {
         bool _drawRoundRect{false};
         bool _drawComplexRoundRect{false};
 
+        /**
+         * Precompute the paints and geometry draw() uses
+         * Called whenever the style or the layout changes so that drawing is only Skia calls
+         */
+        void updatePaint();
+
+        SkPaint _backgroundPaint{};
+        SkPaint _borderPaint{};
+        SkRRect _backgroundRoundRect{};
+        SkRRect _borderRoundRect{};
+        SkRect  _borderRect{};
+
+        /**
+         * One line per visible side when borders are not all the same,
+         * empty (and not allocated) for most divs
+         */
+        struct BorderLine {
+            SkPoint from;
+            SkPoint to;
+            SkPaint paint;
+        };
+        std::vector<BorderLine> _borderLines{};
+
         float    _radiusTopLeft{0.0f};
         float    _radiusTopRight{0.0f};
         float    _radiusBottomLeft{0.0f};
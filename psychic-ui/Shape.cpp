@@ -7,6 +7,10 @@ namespace psychic_ui {
         setTag("Shape");
     }
 
+    bool Shape::occludes() const {
+        return false;
+    }
+
     void Shape::draw(SkCanvas *canvas) {
         if (_drawFunc) {
             // Allow drawing from 0,0 in callback
@@ -15,6 +15,7 @@ namespace psychic_ui {
          * must be provided as a draw callback.
          */
         void draw(SkCanvas *canvas) override;
+        bool occludes() const override;
         std::function<void(Shape *, SkCanvas *)> _drawFunc{};
     };
 }
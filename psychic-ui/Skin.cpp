@@ -55,8 +55,12 @@ namespace psychic_ui {
                 ->set(grow, 1);
         }
 
-        const InheritableValues SkinBase::inheritableValues() const {
+        const InheritableValues &SkinBase::inheritableValues() const {
             return _inheritableValues;
         }
+
+        bool SkinBase::occludes() const {
+            return false;
+        }
     }
 }
@@ -11,7 +11,12 @@ namespace psychic_ui {
             virtual void removedFromComponent() {};
         protected:
             SkinBase();
-            const InheritableValues inheritableValues() const override;
+            const InheritableValues &inheritableValues() const override;
+
+            /**
+             * Skins draw their own chrome with the component's inherited background
+             */
+            bool occludes() const override;
         private:
             static const InheritableValues _inheritableValues;
         };
@@ -1,6 +1,9 @@
 #include <iostream>
 #include "GrBackendSurface.h"
 #include "Window.hpp"
+#include "SkBBHFactory.h"
+#include "SkPictureRecorder.h"
+#include "SkPixmap.h"
 #include "SkSurface.h"
 #include "gl/GrGLInterface.h"
 #include "gl/GrGLUtil.h"
@@ -50,6 +53,7 @@ namespace psychic_ui {
 
     Window::~Window() {
         delete _sk_surface;
+        delete _sk_framebuffer_surface;
         delete _sk_context;
     }
 
@@ -79,8 +83,10 @@ namespace psychic_ui {
     }
 
     void Window::initSkia() {
-        auto interface = GrGLMakeNativeInterface();
-        _sk_context = GrContext::MakeGL(interface).release();
+        if (_systemWindow->hardwareAccelerated()) {
+            auto interface = GrGLMakeNativeInterface();
+            _sk_context = GrContext::MakeGL(interface).release();
+        }
         getSkiaSurface();
     }
 
@@ -90,6 +96,32 @@ namespace psychic_ui {
         }
 
         delete _sk_surface;
+        _sk_surface = nullptr;
+        delete _sk_framebuffer_surface;
+        _sk_framebuffer_surface = nullptr;
+
+        // Whatever was drawn before is gone
+        _damageRect = SkIRect::MakeWH(_systemWindow->getWidth(), _systemWindow->getHeight());
+
+        // setup SkSurface
+        // To use distance field text, use commented out SkSurfaceProps instead
+        // SkSurfaceProps props(SkSurfaceProps::kUseDeviceIndependentFonts_Flag,
+        //                      SkSurfaceProps::kLegacyFontHost_InitType);
+        SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
+
+        if (!_sk_context) {
+            // No GPU context, rasterize in CPU memory
+            _sk_surface = SkSurface::MakeRaster(
+                SkImageInfo::MakeN32Premul(_systemWindow->getWidth(), _systemWindow->getHeight()),
+                &props
+            ).release();
+            if (!_sk_surface) {
+                SkDebugf("SkSurface::MakeRaster returned null\n");
+                return;
+            }
+            _sk_canvas = _sk_surface->getCanvas();
+            return;
+        }
 
         GrGLFramebufferInfo framebufferInfo{};
         framebufferInfo.fFBOID = 0;  // assume default framebuffer
@@ -104,13 +136,7 @@ namespace psychic_ui {
             framebufferInfo
         );
 
-        // setup SkSurface
-        // To use distance field text, use commented out SkSurfaceProps instead
-        // SkSurfaceProps props(SkSurfaceProps::kUseDeviceIndependentFonts_Flag,
-        //                      SkSurfaceProps::kLegacyFontHost_InitType);
-        SkSurfaceProps props(SkSurfaceProps::kLegacyFontHost_InitType);
-
-        _sk_surface = SkSurface::MakeFromBackendRenderTarget(
+        _sk_framebuffer_surface = SkSurface::MakeFromBackendRenderTarget(
             _sk_context,
             backendRenderTarget,
             kBottomLeft_GrSurfaceOrigin,
@@ -118,10 +144,28 @@ namespace psychic_ui {
             nullptr,
             &props
         ).release();
-        if (!_sk_surface) {
+        if (!_sk_framebuffer_surface) {
             SkDebugf("SkSurface::MakeFromBackendRenderTarget returned null\n");
             return;
         }
+
+        _sk_surface = SkSurface::MakeRenderTarget(
+            _sk_context,
+            SkBudgeted::kNo,
+            SkImageInfo::Make(
+                _systemWindow->getWidth(),
+                _systemWindow->getHeight(),
+                kRGBA_8888_SkColorType,
+                kPremul_SkAlphaType
+            ),
+            _systemWindow->getSamples(),
+            kBottomLeft_GrSurfaceOrigin,
+            &props
+        ).release();
+        if (!_sk_surface) {
+            SkDebugf("SkSurface::MakeRenderTarget returned null\n");
+            return;
+        }
         _sk_canvas = _sk_surface->getCanvas();
     }
 
@@ -268,10 +312,10 @@ namespace psychic_ui {
 
     // region Draw
 
-    void Window::drawAll() {
+    bool Window::drawAll() {
         if (!_visible) {
             // TODO: That should not happen
-            return;
+            return false;
         }
 
         //glfwMakeContextCurrent(_glfwWindow);
@@ -292,8 +336,14 @@ namespace psychic_ui {
         // Check for dirty style manager
         // Before layout since it can have an impact on the layout
         if (!_styleManager->valid()) {
-            updateStyleRecursive();
+            if (_styleTaskPool) {
+                updateStyleRecursive(*_styleTaskPool);
+            } else {
+                updateStyleRecursive();
+            }
             _styleManager->setValid();
+        } else if (_styleDirty || _hasDirtyDescendants) {
+            updateInvalidStyles();
         }
 
         // Do Layout
@@ -317,12 +367,33 @@ namespace psychic_ui {
             #endif
         }
 
+        #ifdef DEBUG_LAYOUT
+        if (debugLayout) {
+            // Debug overlays are not tracked, redraw everything
+            damage(_rect);
+        }
+        #endif
+
+        if (_damageRect.isEmpty() || !_sk_canvas) {
+            return false;
+        }
+
+        // Damage happening while rendering goes to the next frame
+        SkRect damaged = SkRect::Make(_damageRect);
+        _damageRect.setEmpty();
+
         //glViewport(0, 0, _fbWidth, _fbHeight);
         //glBindSampler(0, 0);
 
-        _sk_canvas->clear(0x00000000);
-        render(_sk_canvas);
-        _sk_canvas->flush();
+        _displayList = recordFrame(damaged);
+        replayFrame(_displayList, damaged);
+
+        if (_sk_framebuffer_surface) {
+            SkPaint paint;
+            paint.setBlendMode(SkBlendMode::kSrc);
+            _sk_surface->draw(_sk_framebuffer_surface->getCanvas(), 0, 0, &paint);
+            _sk_framebuffer_surface->getCanvas()->flush();
+        }
 
         // Performance
         ++frames;
@@ -335,6 +406,123 @@ namespace psychic_ui {
             fps        = frames / (delta / 1000.0f);
             frames     = 0;
         }
+
+        return true;
+    }
+
+    sk_sp<SkPicture> Window::recordFrame(const SkRect &area) {
+        // Indexed so that replaying part of the list only visits the operations it covers
+        SkRTreeFactory    rtree;
+        SkPictureRecorder recorder;
+        SkCanvas          *canvas = recorder.beginRecording(area, &rtree);
+
+        // Front-to-back first, so that subtrees hidden behind opaque divs (ex: a full window
+        // modal over a heavy view) are not drawn at all
+        Occluders          occluders{};
+        const unsigned int pass = nextOcclusionPass();
+        cullOccluded(occluders, area, 0, 0, pass);
+
+        renderedOcclusionPass = pass;
+        render(canvas);
+        renderedOcclusionPass = 0;
+
+        return recorder.finishRecordingAsPicture();
+    }
+
+    void Window::replayFrame(const sk_sp<SkPicture> &displayList, const SkRect &area) {
+        if (_rasterTaskPool && replayTiles(displayList, area)) {
+            return;
+        }
+
+        _sk_canvas->save();
+        _sk_canvas->clipRect(area);
+        _sk_canvas->clear(0x00000000);
+        _sk_canvas->drawPicture(displayList);
+        _sk_canvas->restore();
+        _sk_canvas->flush();
+    }
+
+    int Window::rasterTileSize = 256;
+
+    bool Window::replayTiles(const sk_sp<SkPicture> &displayList, const SkRect &area) {
+        if (!_sk_surface) {
+            return false;
+        }
+
+        const SkMatrix matrix = _sk_canvas->getTotalMatrix();
+        SkIRect        bounds = matrix.mapRect(area).roundOut();
+        if (!bounds.intersect(SkIRect::MakeWH(_sk_surface->width(), _sk_surface->height()))) {
+            return true;
+        }
+        if (bounds.width() <= rasterTileSize && bounds.height() <= rasterTileSize) {
+            return false;
+        }
+
+        // Snapshots share the surface pixels until it is drawn to, we are about to write to
+        // them behind its back. This has to come before peeking: with a snapshot alive the
+        // surface moves to a copy of its pixels and the peeked ones would be the snapshot's.
+        _sk_surface->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+
+        SkPixmap pixels;
+        if (!_sk_surface->peekPixels(&pixels)) {
+            return false;
+        }
+
+        TaskGroup group{*_rasterTaskPool};
+        for (int y = bounds.top(); y < bounds.bottom(); y += rasterTileSize) {
+            for (int x = bounds.left(); x < bounds.right(); x += rasterTileSize) {
+                SkIRect tile = SkIRect::MakeXYWH(x, y, rasterTileSize, rasterTileSize);
+                tile.intersect(bounds);
+                group.run(
+                    [&displayList, &area, &matrix, &pixels, tile]() {
+                        SkPixmap tilePixels;
+                        if (!pixels.extractSubset(&tilePixels, tile)) {
+                            return;
+                        }
+                        auto canvas = SkCanvas::MakeRasterDirect(
+                            tilePixels.info(), tilePixels.writable_addr(), tilePixels.rowBytes()
+                        );
+                        canvas->translate(-tile.x(), -tile.y());
+                        canvas->concat(matrix);
+                        canvas->clipRect(area);
+                        canvas->clear(0x00000000);
+                        canvas->drawPicture(displayList);
+                    }
+                );
+            }
+        }
+        group.wait();
+        return true;
+    }
+
+    void Window::damage(const SkRect &rect) {
+        SkIRect damaged = rect.roundOut();
+        // Antialiased edges can bleed a pixel out of the rects
+        damaged.outset(1, 1);
+        if (damaged.intersect(SkIRect::MakeWH(windowWidth(), windowHeight()))) {
+            _damageRect.join(damaged);
+        }
+    }
+
+    const SkIRect &Window::damageRect() const {
+        return _damageRect;
+    }
+
+    bool Window::needsRender() const {
+        return _visible
+               && (!_damageRect.isEmpty()
+                   || !_styleManager->valid()
+                   || _styleDirty
+                   || _hasDirtyDescendants
+                   || YGNodeIsDirty(_yogaNode));
+    }
+
+    const sk_sp<SkPicture> &Window::displayList() const {
+        return _displayList;
+    }
+
+    sk_sp<SkImage> Window::snapshot() {
+        return _sk_surface ? _sk_surface->makeImageSnapshot() : nullptr;
     }
 
     // endregion
@@ -363,6 +551,26 @@ namespace psychic_ui {
 
     // endregion
 
+    // region Style
+
+    std::shared_ptr<TaskPool> Window::getStyleTaskPool() const {
+        return _styleTaskPool;
+    }
+
+    void Window::setStyleTaskPool(std::shared_ptr<TaskPool> taskPool) {
+        _styleTaskPool = std::move(taskPool);
+    }
+
+    std::shared_ptr<TaskPool> Window::getRasterTaskPool() const {
+        return _rasterTaskPool;
+    }
+
+    void Window::setRasterTaskPool(std::shared_ptr<TaskPool> taskPool) {
+        _rasterTaskPool = std::move(taskPool);
+    }
+
+    // endregion
+
     // region Focus
 
     void Window::requestFocus(Div *component) {
@@ -8,12 +8,15 @@
 #include "GrContext.h"
 #include "SkSurface.h"
 #include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkPicture.h"
 #include "Div.hpp"
 #include "Modal.hpp"
 #include "style/StyleManager.hpp"
 #include "style/Style.hpp"
 #include "components/Menu.hpp"
 #include "signals/Signal.hpp"
+#include "utils/TaskPool.hpp"
 #include "ApplicationBase.hpp"
 
 namespace psychic_ui {
@@ -61,7 +64,56 @@ namespace psychic_ui {
 
         void open(SystemWindow *systemWindow);
         void close();
-        void drawAll();
+
+        /**
+         * Update styles and layout, then redraw the damaged area of the window
+         * @return Whether anything was drawn, when false the previous frame is still valid
+         */
+        bool drawAll();
+
+        /**
+         * Mark an area of the window as needing to be redrawn on the next frame
+         * @param rect Rect in window coordinates
+         */
+        void damage(const SkRect &rect);
+
+        /**
+         * Area that will be redrawn on the next frame
+         * @return Rect in window coordinates, empty when nothing needs to be redrawn
+         */
+        const SkIRect &damageRect() const;
+
+        /**
+         * Whether the next call to drawAll has something to do
+         * Used by the on demand render mode to sleep while nothing changes
+         */
+        bool needsRender() const;
+
+        /**
+         * Snapshot of the window surface, as it was after the last frame
+         * @return Image or nullptr when the window has no surface yet
+         */
+        sk_sp<SkImage> snapshot();
+
+        /**
+         * Display list of the last frame, what drawAll() replayed onto the window surface
+         * Only the damaged area is recorded. The list is immutable, it can be replayed again
+         * or from another thread while the tree changes.
+         * @return Picture in window coordinates, nullptr before the first frame
+         */
+        const sk_sp<SkPicture> &displayList() const;
+
+        /**
+         * Pool used to replay display lists in tiles, in parallel, when the window surface is
+         * a CPU raster, nullptr (the default) replays them on the thread drawing the window
+         */
+        std::shared_ptr<TaskPool> getRasterTaskPool() const;
+        void setRasterTaskPool(std::shared_ptr<TaskPool> taskPool);
+
+        /**
+         * Width and height of the tiles replayed in parallel, in pixels
+         */
+        static int rasterTileSize;
 
         void openMenu(const std::vector<std::shared_ptr<MenuItem>> &items, int x, int y);
         void closeMenu();
@@ -103,6 +155,13 @@ namespace psychic_ui {
             updateRuntimeStyles();
         }
 
+        /**
+         * Pool used to restyle the whole window in parallel when the style manager changes
+         * (stylesheet loaded, fonts, etc.), nullptr (the default) restyles on the main thread
+         */
+        std::shared_ptr<TaskPool> getStyleTaskPool() const;
+        void setStyleTaskPool(std::shared_ptr<TaskPool> taskPool);
+
         // endregion
 
         // region Focus
@@ -164,6 +223,52 @@ namespace psychic_ui {
         SkSurface    *_sk_surface{nullptr};
         SkCanvas     *_sk_canvas{nullptr};
 
+        /**
+         * Default framebuffer when hardware accelerated
+         * We draw into _sk_surface, which keeps its content between frames,
+         * and copy it here since the back buffer content is undefined after a swap.
+         */
+        SkSurface *_sk_framebuffer_surface{nullptr};
+
+        /**
+         * Accumulated damage for the next frame, in window coordinates
+         */
+        SkIRect _damageRect{SkIRect::MakeEmpty()};
+
+        sk_sp<SkPicture> _displayList{nullptr};
+
+        /**
+         * Record phase of a frame, walk the tree and record what it draws in an area
+         * @param area Rect in window coordinates, subtrees outside of it are skipped
+         * @return Display list of the area
+         */
+        sk_sp<SkPicture> recordFrame(const SkRect &area);
+
+        /**
+         * Replay phase of a frame, rasterize a display list onto the window surface
+         * @param displayList
+         * @param area Rect in window coordinates the display list covers
+         */
+        void replayFrame(const sk_sp<SkPicture> &displayList, const SkRect &area);
+
+        std::shared_ptr<TaskPool> _rasterTaskPool{nullptr};
+
+        /**
+         * Replay a display list in tiles on the raster task pool, writing straight into the
+         * pixels of a CPU raster surface, each tile only touches its own pixels
+         * @param displayList
+         * @param area Rect in window coordinates the display list covers
+         * @return Whether the list was replayed, false when the surface has no pixels to
+         *         write into (ex: hardware accelerated) or when the area fits in a single tile
+         */
+        bool replayTiles(const sk_sp<SkPicture> &displayList, const SkRect &area);
+
+        // endregion
+
+        // region Style
+
+        std::shared_ptr<TaskPool> _styleTaskPool{nullptr};
+
         // endregion
 
         // region Window
@@ -1,5 +1,7 @@
 #ifdef WITH_GLFW
 
+#include <algorithm>
+#include <thread>
 #include <unicode/unistr.h>
 #include "GLFWApplication.hpp"
 
@@ -92,13 +94,28 @@ namespace psychic_ui {
         running = true;
 
         while (running) {
-            glfwPollEvents();
+            if (_renderMode == RenderMode::OnDemand) {
+                waitEvents();
+            } else {
+                double wait = timeUntilNextFrame();
+                if (wait > 0.0) {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+                }
+                glfwPollEvents();
+            }
 
             int       numScreens = 0;
+            bool      drawn      = false;
             for (auto &kv : glfwWindows) {
                 if (kv.second->render()) {
                     numScreens++;
                 }
+                drawn = kv.second->frameDrawn() || drawn;
+            }
+
+            // Idle iterations don't count against the frame rate cap
+            if (drawn) {
+                frameRendered();
             }
 
             // Cleanup dirty managers
@@ -113,6 +130,33 @@ namespace psychic_ui {
         }
     }
 
+    void GLFWApplication::waitEvents() {
+        if (!needsRender()) {
+            // Nothing to draw, sleep until something happens
+            glfwWaitEvents();
+        }
+
+        // Keep handling events until the frame rate cap lets us render
+        for (double wait = timeUntilNextFrame(); wait > 0.0 && needsRender(); wait = timeUntilNextFrame()) {
+            glfwWaitEventsTimeout(wait);
+        }
+
+        // Don't starve the events when rendering every frame
+        glfwPollEvents();
+    }
+
+    bool GLFWApplication::needsRender() const {
+        return std::any_of(
+            glfwWindows.cbegin(),
+            glfwWindows.cend(),
+            [](const auto &kv) { return kv.second->window()->needsRender(); }
+        );
+    }
+
+    void GLFWApplication::wake() {
+        glfwPostEmptyEvent();
+    }
+
     void GLFWApplication::open(std::shared_ptr<Window> window) {
         auto systemWindow = std::make_unique<GLFWSystemWindow>(this, window);
         glfwWindows[systemWindow->glfwWindow()] = std::move(systemWindow);
@@ -200,7 +244,8 @@ namespace psychic_ui {
 
         glClearColor(0, 0, 0, 0);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-        glfwSwapInterval(0);
+        // With vsync the buffer swaps pace the frames on the display refresh
+        glfwSwapInterval(_glfwApplication->getVsync() ? 1 : 0);
         glfwSwapBuffers(_glfwWindow);
 
         #if defined(__APPLE__)
@@ -248,9 +293,11 @@ namespace psychic_ui {
 
     bool GLFWSystemWindow::render() {
         if (!_window->getVisible()) {
+            _frameDrawn = false;
             return false;
         } else if (glfwWindowShouldClose(_glfwWindow)) {
             _window->setVisible(false);
+            _frameDrawn = false;
             return false;
         }
 
@@ -273,9 +320,11 @@ namespace psychic_ui {
         //}
         //#endif
 
-        _window->drawAll();
-
-        glfwSwapBuffers(_glfwWindow);
+        // Only swap when something was drawn, the front buffer is still good otherwise
+        _frameDrawn = _window->drawAll();
+        if (_frameDrawn) {
+            glfwSwapBuffers(_glfwWindow);
+        }
 
         return true;
     }
@@ -472,6 +521,8 @@ namespace psychic_ui {
             _glfwWindow, [](GLFWwindow *w) {
                 auto it = GLFWApplication::glfwWindows.find(w);
                 if (it == GLFWApplication::glfwWindows.cend()) { return; }
+                // The system lost our content, redraw everything
+                it->second->window()->invalidateRender();
                 it->second->render();
             }
         );
@@ -48,10 +48,17 @@ namespace psychic_ui {
         void open(std::shared_ptr<Window> window) override;
         void close(std::shared_ptr<Window> window) override;
         void shutdown() override;
+        void wake() override;
     protected:
         static std::unordered_map<GLFWwindow *, std::unique_ptr<GLFWSystemWindow>> glfwWindows;
 
         bool running{false};
+
+        /**
+         * Block until there is something to render, used by the on demand render mode
+         */
+        void waitEvents();
+        bool needsRender() const;
     };
 
     class GLFWSystemWindow : public SystemWindow {
@@ -0,0 +1,333 @@
+#ifdef WITH_HEADLESS
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include "SkData.h"
+#include "SkStream.h"
+#include "HeadlessApplication.hpp"
+
+namespace psychic_ui {
+
+    // APPLICATION
+
+    void HeadlessApplication::init() {
+        std::cout << "Headless application, rendering on the CPU" << std::endl;
+    }
+
+    void HeadlessApplication::mainloop() {
+        if (running) {
+            throw std::runtime_error("Main loop is already running!");
+        }
+
+        running = true;
+
+        while (running) {
+            int numScreens = step();
+
+            if (numScreens == 0) {
+                running = false;
+                break;
+            }
+
+            if (_frameLimit > 0) {
+                if (_frames >= _frameLimit) {
+                    running = false;
+                }
+            } else {
+                // Without a frame limit we stop once everything that was queued has been rendered
+                running = std::any_of(
+                    headlessWindows.cbegin(),
+                    headlessWindows.cend(),
+                    [](const auto &systemWindow) { return systemWindow->hasPendingEvents(); }
+                );
+            }
+        }
+    }
+
+    int HeadlessApplication::step() {
+        int numScreens = 0;
+        for (auto &systemWindow : headlessWindows) {
+            systemWindow->dispatchEvents();
+            if (systemWindow->render()) {
+                numScreens++;
+            }
+        }
+
+        // Cleanup dirty managers
+        for (auto &systemWindow : headlessWindows) {
+            systemWindow->window()->styleManager()->setValid();
+        }
+
+        ++_frames;
+
+        return numScreens;
+    }
+
+    void HeadlessApplication::open(std::shared_ptr<Window> window) {
+        headlessWindows.push_back(std::make_unique<HeadlessSystemWindow>(this, window));
+    }
+
+    void HeadlessApplication::close(std::shared_ptr<Window> window) {
+        headlessWindows.erase(
+            std::remove_if(
+                headlessWindows.begin(),
+                headlessWindows.end(),
+                [&window](const auto &systemWindow) { return systemWindow->_window == window; }
+            ),
+            headlessWindows.end()
+        );
+    }
+
+    void HeadlessApplication::shutdown() {
+        headlessWindows.clear();
+    }
+
+    HeadlessSystemWindow *HeadlessApplication::systemWindow(const std::shared_ptr<Window> &window) const {
+        auto res = std::find_if(
+            headlessWindows.cbegin(),
+            headlessWindows.cend(),
+            [&window](const auto &systemWindow) { return systemWindow->_window == window; }
+        );
+        return res != headlessWindows.cend() ? res->get() : nullptr;
+    }
+
+    unsigned int HeadlessApplication::getFrameLimit() const {
+        return _frameLimit;
+    }
+
+    void HeadlessApplication::setFrameLimit(const unsigned int frameLimit) {
+        _frameLimit = frameLimit;
+    }
+
+    unsigned int HeadlessApplication::frames() const {
+        return _frames;
+    }
+
+    // WINDOW
+
+    HeadlessSystemWindow::HeadlessSystemWindow(HeadlessApplication *application, std::shared_ptr<Window> window) :
+        SystemWindow(application, window), _headlessApplication(application) {
+        // There is nothing to multisample or stencil into when rendering on the CPU
+        _samples     = 0;
+        _stencilBits = 0;
+        _pixelRatio  = 1.0f;
+
+        window->open(this);
+    }
+
+    bool HeadlessSystemWindow::hardwareAccelerated() const {
+        return false;
+    }
+
+    bool HeadlessSystemWindow::render() {
+        if (!_window->getVisible()) {
+            _frameDrawn = false;
+            return false;
+        }
+
+        // When nothing was damaged the surface still holds the previous frame, which is this frame too
+        _frameDrawn = _window->drawAll();
+        ++_frames;
+
+        if (!_frameDumpDirectory.empty()) {
+            char filename[32];
+            std::snprintf(filename, sizeof(filename), "frame-%05u.png", _frames);
+            saveFrame(_frameDumpDirectory + "/" + filename);
+        }
+
+        return true;
+    }
+
+    // region Synthetic Events
+
+    void HeadlessSystemWindow::mouseMove(const int x, const int y) {
+        queue(
+            [this, x, y]() {
+                _mouseX = x;
+                _mouseY = y;
+                _window->mouseMoved(_mouseX, _mouseY, _mouseState, _modifiers, false);
+            }
+        );
+    }
+
+    void HeadlessSystemWindow::mouseButton(const MouseButton button, const bool down) {
+        queue(
+            [this, button, down]() {
+                if (down) {
+                    _mouseState |= button;
+                } else {
+                    _mouseState &= ~button;
+                }
+                _window->mouseButton(_mouseX, _mouseY, button, down, _modifiers);
+            }
+        );
+    }
+
+    void HeadlessSystemWindow::click(const int x, const int y, const MouseButton button) {
+        mouseMove(x, y);
+        mouseButton(button, true);
+        mouseButton(button, false);
+    }
+
+    void HeadlessSystemWindow::scroll(const double x, const double y) {
+        queue(
+            [this, x, y]() {
+                _window->mouseScrolled(_mouseX, _mouseY, x, y);
+            }
+        );
+    }
+
+    void HeadlessSystemWindow::keyDown(const Key key, const Mod modifiers) {
+        queue(
+            [this, key, modifiers]() {
+                _modifiers = modifiers;
+                _window->keyDown(key, _modifiers);
+            }
+        );
+    }
+
+    void HeadlessSystemWindow::keyUp(const Key key, const Mod modifiers) {
+        queue(
+            [this, key, modifiers]() {
+                _modifiers = modifiers;
+                _window->keyUp(key, _modifiers);
+            }
+        );
+    }
+
+    void HeadlessSystemWindow::type(const icu::UnicodeString &text) {
+        for (int32_t i = 0; i < text.length(); i = text.moveIndex32(i, 1)) {
+            icu::UnicodeString character(text.char32At(i));
+            queue(
+                [this, character]() {
+                    _window->keyboardCharacterEvent(character);
+                }
+            );
+        }
+    }
+
+    void HeadlessSystemWindow::resize(const int width, const int height) {
+        queue(
+            [this, width, height]() {
+                _width  = width;
+                _height = height;
+                _window->windowResized(_width, _height);
+            }
+        );
+    }
+
+    void HeadlessSystemWindow::queue(std::function<void()> event) {
+        _events.push_back(std::move(event));
+    }
+
+    bool HeadlessSystemWindow::hasPendingEvents() const {
+        return !_events.empty();
+    }
+
+    void HeadlessSystemWindow::dispatchEvents() {
+        // Events queued while dispatching are kept for the next frame
+        auto events = std::move(_events);
+        _events.clear();
+        for (auto &event : events) {
+            event();
+        }
+    }
+
+    // endregion
+
+    // region Frames
+
+    unsigned int HeadlessSystemWindow::frames() const {
+        return _frames;
+    }
+
+    sk_sp<SkImage> HeadlessSystemWindow::snapshot() const {
+        return _window->snapshot();
+    }
+
+    bool HeadlessSystemWindow::saveFrame(const std::string &path) const {
+        auto image = snapshot();
+        if (!image) {
+            std::cerr << "No frame to save to " << path << std::endl;
+            return false;
+        }
+
+        auto data = image->encodeToData(SkEncodedImageFormat::kPNG, 100);
+        if (!data) {
+            std::cerr << "Could not encode frame " << _frames << std::endl;
+            return false;
+        }
+
+        SkFILEWStream stream(path.c_str());
+        if (!stream.isValid() || !stream.write(data->data(), data->size())) {
+            std::cerr << "Could not write frame to " << path << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    const std::string &HeadlessSystemWindow::getFrameDumpDirectory() const {
+        return _frameDumpDirectory;
+    }
+
+    void HeadlessSystemWindow::setFrameDumpDirectory(const std::string &directory) {
+        _frameDumpDirectory = directory;
+    }
+
+    // endregion
+
+    // region System Window
+
+    void HeadlessSystemWindow::setTitle(const std::string &/*title*/) {}
+
+    void HeadlessSystemWindow::setFullscreen(bool /*fullscreen*/) {}
+
+    bool HeadlessSystemWindow::getMinimized() const {
+        return _minimized;
+    }
+
+    void HeadlessSystemWindow::setMinimized(bool minimized) {
+        if (_minimized != minimized) {
+            _minimized = minimized;
+            if (_minimized) {
+                _window->windowMinimized();
+            } else {
+                _window->windowRestored();
+            }
+        }
+    }
+
+    bool HeadlessSystemWindow::getMaximized() const {
+        return _maximized;
+    }
+
+    void HeadlessSystemWindow::setMaximized(bool maximized) {
+        _maximized = maximized;
+    }
+
+    void HeadlessSystemWindow::setVisible(bool /*visible*/) {}
+
+    void HeadlessSystemWindow::setCursor(int /*cursor*/) {}
+
+    void HeadlessSystemWindow::startDrag() {}
+
+    void HeadlessSystemWindow::stopDrag() {}
+
+    void HeadlessSystemWindow::setSize(int width, int height) {
+        _width  = width;
+        _height = height;
+        _window->windowResized(_width, _height);
+    }
+
+    void HeadlessSystemWindow::setPosition(int x, int y) {
+        _x = x;
+        _y = y;
+        _window->windowMoved(_x, _y);
+    }
+
+    // endregion
+}
+
+#endif
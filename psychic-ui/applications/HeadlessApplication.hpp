@@ -0,0 +1,155 @@
+#ifdef WITH_HEADLESS
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <unicode/unistr.h>
+#include "SkImage.h"
+#include "../Window.hpp"
+#include "psychic-ui/ApplicationBase.hpp"
+
+namespace psychic_ui {
+
+    class HeadlessSystemWindow;
+
+    /**
+     * Application running without any windowing system or OpenGL context.
+     *
+     * Windows are rasterized in CPU memory by Skia and receive their input
+     * from a synthetic event queue, which makes it possible to run the UI,
+     * capture its frames and measure it on machines without a GPU or display.
+     */
+    class HeadlessApplication : public ApplicationBase {
+        friend class HeadlessSystemWindow;
+
+    public:
+        void init() override;
+        void mainloop() override;
+        void open(std::shared_ptr<Window> window) override;
+        void close(std::shared_ptr<Window> window) override;
+        void shutdown() override;
+
+        /**
+         * Dispatch the queued events of every window and render one frame of each
+         * @return Number of windows that were rendered
+         */
+        int step();
+
+        /**
+         * Get the system window wrapping a window opened in this application
+         * Used to queue synthetic events and capture frames
+         * @param window
+         * @return HeadlessSystemWindow or nullptr if the window is not opened here
+         */
+        HeadlessSystemWindow *systemWindow(const std::shared_ptr<Window> &window) const;
+
+        /**
+         * Maximum number of frames the main loop will render before returning
+         * When 0, the main loop returns as soon as all event queues are drained
+         */
+        unsigned int getFrameLimit() const;
+        void setFrameLimit(unsigned int frameLimit);
+
+        /**
+         * Number of frames rendered by this application
+         */
+        unsigned int frames() const;
+
+    protected:
+        std::vector<std::unique_ptr<HeadlessSystemWindow>> headlessWindows{};
+
+        bool         running{false};
+        unsigned int _frameLimit{0};
+        unsigned int _frames{0};
+    };
+
+    class HeadlessSystemWindow : public SystemWindow {
+        friend class HeadlessApplication;
+
+    public:
+        HeadlessSystemWindow(HeadlessApplication *application, std::shared_ptr<Window> window);
+        bool render() override;
+        bool hardwareAccelerated() const override;
+
+        // region Synthetic Events
+
+        void mouseMove(int x, int y);
+        void mouseButton(MouseButton button, bool down);
+        void click(int x, int y, MouseButton button = MouseButton::LEFT);
+        void scroll(double x, double y);
+        void keyDown(Key key, Mod modifiers = {});
+        void keyUp(Key key, Mod modifiers = {});
+        void type(const icu::UnicodeString &text);
+        void resize(int width, int height);
+
+        /**
+         * Queue an arbitrary callback, executed in order with the other synthetic events
+         * @param event
+         */
+        void queue(std::function<void()> event);
+
+        bool hasPendingEvents() const;
+
+        /**
+         * Dispatch every queued event to the window
+         * Called before every frame rendered by the application
+         */
+        void dispatchEvents();
+
+        // endregion
+
+        // region Frames
+
+        /**
+         * Number of frames rendered in this window
+         */
+        unsigned int frames() const;
+
+        /**
+         * Snapshot of the last rendered frame
+         */
+        sk_sp<SkImage> snapshot() const;
+
+        /**
+         * Encode the last rendered frame as a PNG file
+         * @param path
+         * @return Whether the file could be written
+         */
+        bool saveFrame(const std::string &path) const;
+
+        /**
+         * Directory where every rendered frame is dumped as a PNG file
+         * Empty (the default) disables the frame dumps
+         */
+        const std::string &getFrameDumpDirectory() const;
+        void setFrameDumpDirectory(const std::string &directory);
+
+        // endregion
+
+    protected:
+        HeadlessApplication *_headlessApplication{nullptr};
+
+        std::deque<std::function<void()>> _events{};
+        Mod                               _modifiers{};
+        unsigned int                      _frames{0};
+        std::string                       _frameDumpDirectory{};
+
+        void setTitle(const std::string &title) override;
+        void setFullscreen(bool fullscreen) override;
+        bool getMinimized() const override;
+        void setMinimized(bool minimized) override;
+        bool getMaximized() const override;
+        void setMaximized(bool maximized) override;
+        void setVisible(bool visible) override;
+        void setCursor(int cursor) override;
+        void startDrag() override;
+        void stopDrag() override;
+        void setSize(int width, int height) override;
+        void setPosition(int x, int y) override;
+    };
+}
+
+#endif
@@ -1,6 +1,9 @@
 #ifdef WITH_SDL2
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <thread>
 #include <unicode/unistr.h>
 #include "SDL2Application.hpp"
 
@@ -49,13 +52,28 @@ namespace psychic_ui {
         running = true;
 
         while (running) {
-            sdl2PollEvents();
+            if (_renderMode == RenderMode::OnDemand) {
+                sdl2WaitEvents();
+            } else {
+                double wait = timeUntilNextFrame();
+                if (wait > 0.0) {
+                    std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+                }
+                sdl2PollEvents();
+            }
 
             int       numScreens = 0;
+            bool      drawn      = false;
             for (auto &kv : sdl2Windows) {
                 if (kv.second->render()) {
                     numScreens++;
                 }
+                drawn = kv.second->frameDrawn() || drawn;
+            }
+
+            // Idle iterations don't count against the frame rate cap
+            if (drawn) {
+                frameRendered();
             }
 
             // Cleanup dirty managers
@@ -82,35 +100,75 @@ namespace psychic_ui {
         SDL_Quit();
     }
 
+    void SDL2Application::wake() {
+        // Any event wakes SDL_WaitEvent up, this one is simply ignored
+        SDL_Event e{};
+        e.type = SDL_USEREVENT;
+        SDL_PushEvent(&e);
+    }
+
+    bool SDL2Application::needsRender() const {
+        return std::any_of(
+            sdl2Windows.cbegin(),
+            sdl2Windows.cend(),
+            [](const auto &kv) { return kv.second->window()->needsRender(); }
+        );
+    }
+
+    void SDL2Application::sdl2WaitEvents() {
+        SDL_Event e{};
+
+        if (!needsRender()) {
+            // Nothing to draw, sleep until something happens
+            if (SDL_WaitEvent(&e) != 0) {
+                sdl2HandleEvent(e);
+            }
+        }
+
+        // Keep handling events until the frame rate cap lets us render
+        for (double wait = timeUntilNextFrame(); wait > 0.0 && needsRender(); wait = timeUntilNextFrame()) {
+            if (SDL_WaitEventTimeout(&e, static_cast<int>(std::ceil(wait * 1000.0))) != 0) {
+                sdl2HandleEvent(e);
+            }
+        }
+
+        // Don't starve the events when rendering every frame
+        sdl2PollEvents();
+    }
+
     void SDL2Application::sdl2PollEvents() {
         SDL_Event e{};
         while (SDL_PollEvent(&e) != 0) {
-            switch (e.type) {
-                case SDL_QUIT: {
-                    running = false;
-                    break;
-                }
-                case SDL_WINDOWEVENT:
-                case SDL_KEYDOWN:
-                case SDL_KEYUP:
-                case SDL_TEXTINPUT:
-                case SDL_TEXTEDITING:
-                case SDL_MOUSEMOTION:
-                case SDL_MOUSEBUTTONDOWN:
-                case SDL_MOUSEBUTTONUP:
-                case SDL_MOUSEWHEEL: {
-                    auto res = sdl2Windows.find(e.window.windowID);
-                    if (res == sdl2Windows.cend()) {
-                        std::cerr << "Received an event for an unregistered window" << std::endl;
-                        break;
-                    }
-                    res->second->handleEvent(e);
+            sdl2HandleEvent(e);
+        }
+    }
+
+    void SDL2Application::sdl2HandleEvent(const SDL_Event &e) {
+        switch (e.type) {
+            case SDL_QUIT: {
+                running = false;
+                break;
+            }
+            case SDL_WINDOWEVENT:
+            case SDL_KEYDOWN:
+            case SDL_KEYUP:
+            case SDL_TEXTINPUT:
+            case SDL_TEXTEDITING:
+            case SDL_MOUSEMOTION:
+            case SDL_MOUSEBUTTONDOWN:
+            case SDL_MOUSEBUTTONUP:
+            case SDL_MOUSEWHEEL: {
+                auto res = sdl2Windows.find(e.window.windowID);
+                if (res == sdl2Windows.cend()) {
+                    std::cerr << "Received an event for an unregistered window" << std::endl;
                     break;
                 }
-                default:
-                    break;
-
+                res->second->handleEvent(e);
+                break;
             }
+            default:
+                break;
+
         }
     }
 
@@ -206,6 +264,11 @@ namespace psychic_ui {
             throw std::runtime_error("Could not make SDL2 GL context current!");
         }
 
+        // With vsync the buffer swaps pace the frames on the display refresh
+        if (SDL_GL_SetSwapInterval(_sdl2Application->getVsync() ? 1 : 0) != 0) {
+            logSDLError("SDL_GL_SetSwapInterval");
+        }
+
         // Get Some info back about the framebuffer (in case its different from what we set?)
         //glGetFramebufferAttachmentParameteriv(
         //    GL_DRAW_FRAMEBUFFER,
@@ -257,12 +320,15 @@ namespace psychic_ui {
 
     bool SDL2SystemWindow::render() {
         if (!_window->getVisible()) {
+            _frameDrawn = false;
             return false;
         }
 
-        _window->drawAll();
-
-        SDL_GL_SwapWindow(_sdl2Window);
+        // Only swap when something was drawn, the front buffer is still good otherwise
+        _frameDrawn = _window->drawAll();
+        if (_frameDrawn) {
+            SDL_GL_SwapWindow(_sdl2Window);
+        }
 
         return true;
     }
@@ -364,6 +430,8 @@ namespace psychic_ui {
                     case SDL_WINDOWEVENT_HIDDEN:
                         break;
                     case SDL_WINDOWEVENT_EXPOSED:
+                        // The system lost our content, redraw everything
+                        _window->invalidateRender();
                         break;
                     case SDL_WINDOWEVENT_MOVED:
                         _x = e.window.data1;
@@ -36,9 +36,17 @@ namespace psychic_ui {
         void open(std::shared_ptr<Window> window) override;
         void close(std::shared_ptr<Window> window) override;
         void shutdown() override;
+        void wake() override;
     protected:
         bool running{false};
         void sdl2PollEvents();
+
+        /**
+         * Block until there is something to render, used by the on demand render mode
+         */
+        void sdl2WaitEvents();
+        void sdl2HandleEvent(const SDL_Event &e);
+        bool needsRender() const;
     };
 
     class SDL2SystemWindow : public SystemWindow {
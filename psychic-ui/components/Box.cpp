@@ -4,9 +4,13 @@ namespace psychic_ui {
 
     // BOX
 
-    Box::Box(int gap) :
-        Div(), _gap(gap) {
+    Box::Box(int boxGap) :
+        Div() {
         setTag("Box");
+
+        // Gap is a default so that the stylesheet can still override it
+        _defaultStyle
+            ->set(gap, boxGap);
     }
 
 
@@ -14,21 +18,8 @@ namespace psychic_ui {
         return _gap;
     }
 
-    void Box::setGap(int gap) {
-        if (gap != _gap) {
-            _gap = gap;
-            updateRules();
-        }
-    }
-
-    void Box::styleUpdated() {
-        Div::styleUpdated();
-        setGap(_computedStyle->get(gap));
-    }
-
-    void Box::createStyles() {
-        Div::createStyles();
-        updateRules();
+    void Box::setGap(int boxGap) {
+        _inlineStyle->set(gap, boxGap);
     }
 
     // HBOX
@@ -44,18 +35,6 @@ namespace psychic_ui {
             ->set(flexDirection, "row");
     }
 
-    void HBox::updateRules() {
-        // Once we have access to a style manager add a custom rule targeting us by internal id
-        if (auto sm = styleManager()) {
-            sm->style("#" + _internalId + " > div")
-              ->set(marginRight, _gap); // This is our gap, we'll need to cancel it for the last child
-            sm->style("#" + _internalId + " > div:last-child")
-              ->set(marginRight, 0); // Last child gap cancellation
-        }
-    }
-
-
-
     // VBOX
 
     VBox::VBox() :
@@ -68,14 +47,4 @@ namespace psychic_ui {
         _inlineStyle
             ->set(flexDirection, "column");
     }
-
-    void VBox::updateRules() {
-        // Once we have access to a style manager add a custom rule targeting us by internal id
-        if (auto sm = styleManager()) {
-            sm->style("#" + _internalId + " > div")
-              ->set(marginBottom, _gap); // This is our gap, we'll need to cancel it for the last child
-            sm->style("#" + _internalId + " > div:last-child")
-              ->set(marginBottom, 0); // Last child gap cancellation
-        }
-    }
 }
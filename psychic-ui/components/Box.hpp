@@ -4,6 +4,10 @@
 
 namespace psychic_ui {
 
+    /**
+     * Base of the boxes, containers spacing their children with a gap
+     * The gap is a layout feature of every div (the `gap` style), boxes only set a default one
+     */
     class Box : public Div {
     public:
         int getGap() const;
@@ -11,10 +15,6 @@ namespace psychic_ui {
     protected:
         Box() = default;
         explicit Box(int gap);
-        int _gap{0};
-        virtual void updateRules() = 0;
-        void styleUpdated() override;
-        void createStyles() override;
     };
 
     /**
@@ -24,8 +24,6 @@ namespace psychic_ui {
     public:
         HBox();
         explicit HBox(int gap);
-    protected:
-        void updateRules() override ;
     };
 
 
@@ -36,7 +34,5 @@ namespace psychic_ui {
     public:
         VBox();
         explicit VBox(int gap);
-    protected:
-        void updateRules() override;
     };
 }
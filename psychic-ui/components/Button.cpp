@@ -58,7 +58,7 @@ namespace psychic_ui {
     Button *Button::setSelected(const bool selected) {
         if (_selected != selected) {
             _selected = selected;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::active);
             if (_onChange) {
                 _onChange(_selected);
             }
@@ -23,6 +23,10 @@ namespace psychic_ui {
                 }
             }
         );
+
+        // The skin draws the hover state without needing a style change
+        onMouseOver.subscribe([this]() { invalidateRender(); });
+        onMouseOut.subscribe([this]() { invalidateRender(); });
     }
 
     const std::string &CheckBox::label() const {
@@ -41,7 +45,8 @@ namespace psychic_ui {
     CheckBox *CheckBox::setChecked(const bool checked) {
         if (_checked != checked) {
             _checked = checked;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::active);
+            invalidateRender();
             onChange(_checked);
         }
         return this;
@@ -1,72 +1,349 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <SkCanvas.h>
 #include "psychic-ui/Div.hpp"
 
 namespace psychic_ui {
 
-    template<class T>
+    namespace internal {
+        /**
+         * Whether keys of type K have an operator< to match them with
+         */
+        template<class K, class = void>
+        struct IsOrderedKey : std::false_type {};
+
+        template<class K>
+        struct IsOrderedKey<K, decltype(void(std::declval<const K &>() < std::declval<const K &>()))> : std::true_type {};
+    }
+
+    /**
+     * Container creating a div for every item of its data
+     *
+     * Items are identified by a key (by default the item itself). When the data changes, the
+     * divs of the items whose key is still present are kept, only the divs of the new items
+     * are created, the divs of the removed items are removed and the fewest possible divs are
+     * moved around, so that the untouched divs keep their state (focus, scroll, styles, ...).
+     *
+     * Keys have to be ordered (have an operator<). When they are not, or when there is no key,
+     * every data change creates all the divs again.
+     *
+     * @tparam T Item type
+     * @tparam K Key type
+     */
+    template<class T, class K = T>
     class DataContainer : public Div {
     public:
         using ContainerData = std::vector<T>;
         using DivCallback = std::function<std::shared_ptr<Div>(const T &)>;
+        /**
+         * Key identifying an item across data changes
+         */
+        using KeyCallback = std::function<K(const T &)>;
+        /**
+         * Update the div of an item that kept its key but whose value changed
+         * Returns false when the div can't be updated and has to be created again
+         */
+        using UpdateCallback = std::function<bool(Div &, const T &)>;
 
-        explicit DataContainer(const ContainerData &data, DivCallback getDiv);
+        /**
+         * @param data Items
+         * @param getDiv Create the div of an item
+         * @param getKey Key of an item, the item itself when nullptr
+         * @param updateDiv Update the div of a changed item, changed items get a new div when nullptr
+         */
+        explicit DataContainer(
+            const ContainerData &data,
+            DivCallback getDiv,
+            KeyCallback getKey = nullptr,
+            UpdateCallback updateDiv = nullptr
+        );
 
-        ContainerData &data() const;
-        virtual DataContainer<T> *setData(const ContainerData &data);
+        const ContainerData &data() const;
+        virtual DataContainer<T, K> *setData(const ContainerData &data);
 
+        DataContainer<T, K> *setKey(KeyCallback getKey);
+        DataContainer<T, K> *setUpdate(UpdateCallback updateDiv);
 
     protected:
         void render(SkCanvas *canvas) override;
-        ContainerData _data{};
-        DivCallback   _getDiv{nullptr};
-        bool          _dataChanged{true};
+
+        /**
+         * Bring the children in line with new data, reusing the divs of the items that kept their key
+         * @param data
+         */
+        void reconcile(const ContainerData &data);
+        void reconcile(const ContainerData &data, std::true_type);
+        void reconcile(const ContainerData &data, std::false_type);
+
+        /**
+         * Replace every child with a new div for each item
+         * @param data
+         */
+        void rebuild(const ContainerData &data);
+
+        /**
+         * Called once the children reflect the data
+         */
+        virtual void divsUpdated() {}
+
+        /**
+         * Identity key, when the item can be its own key and the key is ordered
+         */
+        static KeyCallback defaultKey();
+        static KeyCallback defaultKey(std::true_type);
+        static KeyCallback defaultKey(std::false_type);
+
+        /**
+         * Positions (in the new data) of the longest run of reused divs that are already in order,
+         * those don't have to move
+         * @param sources Previous position of the div of every item, -1 for new divs
+         */
+        static std::vector<bool> inOrder(const std::vector<long> &sources);
+
+        /**
+         * Position of a child in layout order, children are stored last first
+         */
+        unsigned int layoutIndex(const std::shared_ptr<Div> &child) const {
+            return childCount() - 1 - (unsigned int) childIndex(child);
+        }
+
+        ContainerData  _data{};
+        DivCallback    _getDiv{nullptr};
+        KeyCallback    _getKey{nullptr};
+        UpdateCallback _updateDiv{nullptr};
+        bool           _dataChanged{true};
+
+        /**
+         * Div of every item of _data, nullptr for the items without one
+         */
+        std::vector<std::shared_ptr<Div>> _divs{};
 
         // Make some of div's stuff protected since we manage our content
         using Div::add;
+        using Div::move;
         using Div::remove;
         using Div::removeAll;
     };
 
-    template<class T>
-    DataContainer<T>::DataContainer(const typename DataContainer<T>::ContainerData &data, DivCallback getDiv) :
+    template<class T, class K>
+    DataContainer<T, K>::DataContainer(
+        const typename DataContainer<T, K>::ContainerData &data,
+        DivCallback getDiv,
+        KeyCallback getKey,
+        UpdateCallback updateDiv
+    ) :
         Div(),
         _data(data),
-        _getDiv(getDiv) {
+        _getDiv(getDiv),
+        _getKey(getKey ? getKey : defaultKey()),
+        _updateDiv(updateDiv) {
         setTag("DataContainer");
     }
 
-    template<class T>
-    typename DataContainer<T>::ContainerData &DataContainer<T>::data() const {
+    template<class T, class K>
+    const typename DataContainer<T, K>::ContainerData &DataContainer<T, K>::data() const {
         return _data;
     }
 
-    template<class T>
-    DataContainer<T> *DataContainer<T>::setData(const typename DataContainer<T>::ContainerData &data) {
+    template<class T, class K>
+    DataContainer<T, K> *DataContainer<T, K>::setData(const typename DataContainer<T, K>::ContainerData &data) {
         if (data != _data) {
-            _data = data;
-            _dataChanged = true;
+            if (_dataChanged) {
+                // Never rendered, nothing to reuse
+                _data = data;
+            } else {
+                reconcile(data);
+            }
         }
         return this;
     }
 
-    template<class T>
-    void DataContainer<T>::render(SkCanvas *canvas) {
+    template<class T, class K>
+    DataContainer<T, K> *DataContainer<T, K>::setKey(KeyCallback getKey) {
+        _getKey = getKey ? getKey : defaultKey();
+        return this;
+    }
+
+    template<class T, class K>
+    DataContainer<T, K> *DataContainer<T, K>::setUpdate(UpdateCallback updateDiv) {
+        _updateDiv = updateDiv;
+        return this;
+    }
+
+    template<class T, class K>
+    typename DataContainer<T, K>::KeyCallback DataContainer<T, K>::defaultKey() {
+        return defaultKey(
+            std::integral_constant<bool, std::is_convertible<const T &, K>::value && internal::IsOrderedKey<K>::value>{}
+        );
+    }
+
+    template<class T, class K>
+    typename DataContainer<T, K>::KeyCallback DataContainer<T, K>::defaultKey(std::true_type) {
+        return [](const T &item) -> K { return item; };
+    }
+
+    template<class T, class K>
+    typename DataContainer<T, K>::KeyCallback DataContainer<T, K>::defaultKey(std::false_type) {
+        return nullptr;
+    }
+
+    template<class T, class K>
+    void DataContainer<T, K>::render(SkCanvas *canvas) {
         if (_dataChanged) {
-            removeAll();
-            for (const auto &item: _data) {
-                auto div = _getDiv(item);
-                if (div) {
-                    add(div);
-                }
-            }
+            const ContainerData data = std::move(_data);
+            _data.clear();
+            reconcile(data);
             _dataChanged = false;
         }
 
         Div::render(canvas);
     }
 
+    template<class T, class K>
+    void DataContainer<T, K>::reconcile(const typename DataContainer<T, K>::ContainerData &data) {
+        // Only instantiate the keyed path for keys that can be put in a map
+        reconcile(data, internal::IsOrderedKey<K>{});
+    }
 
-}
+    template<class T, class K>
+    void DataContainer<T, K>::reconcile(const typename DataContainer<T, K>::ContainerData &data, std::false_type) {
+        rebuild(data);
+    }
+
+    template<class T, class K>
+    void DataContainer<T, K>::rebuild(const typename DataContainer<T, K>::ContainerData &data) {
+        // No way to match the items, start over
+        const std::size_t count = data.size();
+        removeAll();
+        _divs.assign(count, nullptr);
+        for (std::size_t i = 0; i < count; ++i) {
+            _divs[i] = _getDiv(data[i]);
+            if (_divs[i]) {
+                add(_divs[i]);
+            }
+        }
+        _data = data;
+        divsUpdated();
+    }
 
+    template<class T, class K>
+    void DataContainer<T, K>::reconcile(const typename DataContainer<T, K>::ContainerData &data, std::true_type) {
+        if (!_getKey) {
+            rebuild(data);
+            return;
+        }
+
+        const std::size_t count = data.size();
+
+        // Previous positions by key, last first so that duplicate keys are matched in order
+        std::map<K, std::vector<std::size_t>> previous{};
+        for (std::size_t i = _data.size(); i > 0; --i) {
+            previous[_getKey(_data[i - 1])].push_back(i - 1);
+        }
+
+        std::vector<long>                 sources(count, -1);
+        std::vector<std::shared_ptr<Div>> divs(count);
+        std::vector<bool>                 reused(_data.size(), false);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto match = previous.find(_getKey(data[i]));
+            if (match == previous.end() || match->second.empty()) {
+                continue;
+            }
+            const std::size_t source = match->second.back();
+            match->second.pop_back();
+
+            const auto &div = _divs[source];
+            if (!div) {
+                continue;
+            }
+            if (data[i] == _data[source] || (_updateDiv && _updateDiv(*div, data[i]))) {
+                sources[i]     = static_cast<long>(source);
+                divs[i]        = div;
+                reused[source] = true;
+            }
+        }
+
+        for (std::size_t i = 0; i < _divs.size(); ++i) {
+            if (!reused[i] && _divs[i]) {
+                remove(_divs[i]);
+            }
+        }
+
+        // Every div goes right after the div of the item before it,
+        // the ones already in order don't move
+        const std::vector<bool> stays = inOrder(sources);
+        std::shared_ptr<Div>    after{nullptr};
+        for (std::size_t i = 0; i < count; ++i) {
+            const bool created = !divs[i];
+            if (created) {
+                divs[i] = _getDiv(data[i]);
+                if (!divs[i]) {
+                    continue;
+                }
+            }
+
+            if (created || !stays[i]) {
+                unsigned int index = 0;
+                if (after && after == _children.front()) {
+                    // Appending, the common case when building
+                    index = created ? childCount() : childCount() - 1;
+                } else if (after) {
+                    index = layoutIndex(after) + 1;
+                    if (!created && layoutIndex(divs[i]) < index) {
+                        // Taking it out shifts the target
+                        --index;
+                    }
+                }
+                if (created) {
+                    add(index, divs[i]);
+                } else {
+                    move(divs[i], index);
+                }
+            }
+            after = divs[i];
+        }
+
+        _divs = std::move(divs);
+        _data = data;
+        divsUpdated();
+    }
+
+    template<class T, class K>
+    std::vector<bool> DataContainer<T, K>::inOrder(const std::vector<long> &sources) {
+        // Longest increasing subsequence, O(n log n)
+        std::vector<bool>        result(sources.size(), false);
+        std::vector<std::size_t> tails{};
+        std::vector<long>        parents(sources.size(), -1);
+        for (std::size_t i = 0; i < sources.size(); ++i) {
+            if (sources[i] < 0) {
+                continue;
+            }
+            auto tail = std::lower_bound(
+                tails.begin(), tails.end(), sources[i],
+                [&sources](const std::size_t position, const long source) {
+                    return sources[position] < source;
+                }
+            );
+            if (tail != tails.begin()) {
+                parents[i] = static_cast<long>(*(tail - 1));
+            }
+            if (tail == tails.end()) {
+                tails.push_back(i);
+            } else {
+                *tail = i;
+            }
+        }
+        for (long i = tails.empty() ? -1 : static_cast<long>(tails.back()); i >= 0; i = parents[i]) {
+            result[i] = true;
+        }
+        return result;
+    }
+
+}
@@ -24,7 +24,7 @@ namespace psychic_ui {
     void MenuButton::setSelected(const bool selected) {
         if (_selected != selected) {
             _selected = selected;
-            invalidateStyle();
+            invalidatePseudoStyle(Pseudo::active);
         }
     }
 
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <string>
 #include "Button.hpp"
 #include "DataContainer.hpp"
@@ -25,11 +26,11 @@ namespace psychic_ui {
 
     protected:
         std::shared_ptr<Button> getTab(const T &item);
+        void divsUpdated() override;
         void updateSelection();
-        LabelCallback         _getLabel{nullptr};
-        const T               *_selected{nullptr};
-        std::vector<Button *> _buttons{};
-        TabChanged            _tabChanged{nullptr};
+        LabelCallback      _getLabel{nullptr};
+        std::unique_ptr<T> _selected{nullptr};
+        TabChanged         _tabChanged{nullptr};
     };
 
     template<class T>
@@ -43,9 +44,10 @@ namespace psychic_ui {
 
     template<class T>
     std::shared_ptr<Button> Tabs<T>::getTab(const T &item) {
+        // The tab outlives the data it was created from, keep a copy of the item
         auto tab = std::make_shared<Button>(
             label(item),
-            [&]() {
+            [this, item]() {
                 if (!_selected || item != *_selected) {
                     select(item);
                     if (_tabChanged) {
@@ -56,11 +58,6 @@ namespace psychic_ui {
         );
         tab->setToggle(true)
            ->setAutoToggle(false);
-        _buttons.push_back(tab.get());
-
-        // TODO: This is here for now, until we have a clearer DataContainer lifecycle
-        updateSelection();
-
         return tab;
     }
 
@@ -71,30 +68,40 @@ namespace psychic_ui {
 
     template<class T>
     void Tabs<T>::select(const T &item) {
-        // Find item in data since (pardon my C++ knowledge at this time) when initializing with a temporary data source
-        // and selecting from this data source, the pointer becomes invalid once the original data source expired.
-        auto res = std::find(this->_data.cbegin(), this->_data.cend(), item);
-        if (res != this->_data.cend()) {
-            _selected = &(*res);
+        // Keep a copy, the data changes under the tabs
+        if (std::find(this->_data.cbegin(), this->_data.cend(), item) != this->_data.cend()) {
+            _selected = std::make_unique<T>(item);
         } else {
             _selected = nullptr;
         }
         updateSelection();
     }
 
+    template<class T>
+    void Tabs<T>::divsUpdated() {
+        updateSelection();
+    }
+
     template<class T>
     void Tabs<T>::updateSelection() {
-        auto     pos = std::distance(this->_data.cbegin(), std::find(this->_data.cbegin(), this->_data.cend(), *_selected));
-        for (unsigned int i   = 0; i < _buttons.size(); ++i) {
-            _buttons[i]->setSelected(i == pos);
+        bool found = false;
+        for (std::size_t i = 0; i < this->_divs.size(); ++i) {
+            const bool selected = !found && _selected && this->_data[i] == *_selected;
+            found = found || selected;
+            auto button = std::static_pointer_cast<Button>(this->_divs[i]);
+            if (button) {
+                button->setSelected(selected);
+            }
         }
     }
 
     template<class T>
     Tabs<T> *Tabs<T>::setData(const typename DataContainer<T>::ContainerData &data) {
-        _selected = nullptr;
-        _buttons.clear();
+        // Tabs are kept across data changes, and so is the selection if it still exists
         DataContainer<T>::setData(data);
+        if (_selected) {
+            select(*_selected);
+        }
         return this;
     }
 
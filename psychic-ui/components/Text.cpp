@@ -34,6 +34,7 @@ namespace psychic_ui {
         _caret       = 0;
         _selectBegin = 0;
         _selectEnd   = 0;
+        invalidateRender();
         return this;
     }
 
@@ -93,6 +94,7 @@ namespace psychic_ui {
         if (_selectBegin > _selectEnd) {
             std::swap(_selectBegin, _selectEnd);
         }
+        invalidateRender();
 
         onCaret(_selectEnd);
         onSelection(_selectBegin, _selectEnd);
@@ -111,6 +113,7 @@ namespace psychic_ui {
         if (saveX) {
             _targetXPos = _textBox.posFromIndex(_caret).second;
         }
+        invalidateRender();
         if (isValid()) {
             std::cout << "on caret is valid" << std::endl;
             onCaret(_caret);
@@ -150,6 +153,7 @@ namespace psychic_ui {
                             _selectBegin = _caret;
                             _selectEnd   = initialBegin;
                         }
+                        invalidateRender();
                         onCaret(_caret);
                         onSelection(_selectBegin, _selectEnd);
                     }
@@ -180,6 +184,7 @@ namespace psychic_ui {
                     _selectBegin = 0;
                     _selectEnd   = static_cast<unsigned int>(_text.length());
                 }
+                invalidateRender();
                 onSelection(_selectBegin, _selectEnd);
             }
         );
@@ -209,10 +214,10 @@ namespace psychic_ui {
             [this](icu::UnicodeString character) {
                 if (_selectBegin != _selectEnd) {
                     _text.replace(_selectBegin, _selectEnd - _selectBegin, character);
-                    textEdited(_selectBegin + 1);
+                    textEdited(_selectBegin + 1, _selectBegin, _selectEnd - _selectBegin, static_cast<unsigned int>(character.length()));
                 } else {
                     _text.insert(_caret, character);
-                    textEdited(++_caret);
+                    textEdited(_caret + 1, _caret, 0, static_cast<unsigned int>(character.length()));
                 }
             }
         );
@@ -246,17 +251,28 @@ namespace psychic_ui {
         invalidate();
     }
 
+    void Text::textChanged(unsigned int start, unsigned int removed, unsigned int inserted) {
+        _textBox.updateText(start, removed, inserted);
+        invalidate();
+    }
+
     void Text::textEdited(unsigned int caret) {
         textChanged(); // Before setCaret so that `onCaret` has access to computed lines
         setCaret(caret);
     }
 
+    void Text::textEdited(unsigned int caret, unsigned int start, unsigned int removed, unsigned int inserted) {
+        textChanged(start, removed, inserted); // Before setCaret so that `onCaret` has access to computed lines
+        setCaret(caret);
+    }
+
     void Text::handleKey(Key key, Mod mod) {
         switch (key) {
             case Key::A:
                 if (mod.ctrl or mod.super) {
                     _selectBegin = 0;
                     _selectEnd   = static_cast<unsigned int>(_text.length());
+                    invalidateRender();
                     onSelection(_selectBegin, _selectEnd);
                 }
                 break;
@@ -328,16 +344,16 @@ namespace psychic_ui {
                     if (_selectBegin != _selectEnd) {
                         // Remove selection
                         _text.remove(_selectBegin, _selectEnd - _selectBegin);
-                        textEdited(_selectBegin);
+                        textEdited(_selectBegin, _selectBegin, _selectEnd - _selectBegin, 0);
                     } else if (mod.ctrl) {
                         // Remove preceding word
                         auto from = _textBox.previousWordBoundary(_caret);
                         _text.removeBetween(from, _caret);
-                        textEdited(from);
+                        textEdited(from, from, _caret - from, 0);
                     } else {
                         // Remove preceding character
                         _text.remove(_caret - 1, 1);
-                        textEdited(--_caret);
+                        textEdited(_caret - 1, _caret - 1, 1, 0);
                     }
                 }
                 break;
@@ -347,15 +363,16 @@ namespace psychic_ui {
                     if (_selectBegin != _selectEnd) {
                         // Delete selection
                         _text.remove(_selectBegin, _selectEnd - _selectBegin);
-                        textEdited(_selectBegin);
+                        textEdited(_selectBegin, _selectBegin, _selectEnd - _selectBegin, 0);
                     } else if (mod.ctrl) {
                         // Delete following word
-                        _text.removeBetween(_caret, _textBox.nextWordBoundary(_caret));
-                        textChanged();
+                        auto to = _textBox.nextWordBoundary(_caret);
+                        _text.removeBetween(_caret, to);
+                        textChanged(_caret, to - _caret, 0);
                     } else {
                         // Delete following character
                         _text.remove(_caret, 1);
-                        textChanged();
+                        textChanged(_caret, 1, 0);
                     }
                 }
                 break;
@@ -365,10 +382,10 @@ namespace psychic_ui {
                     icu::UnicodeString uni_str(static_cast<UChar32>('\n'));
                     if (_selectBegin != _selectEnd) {
                         _text.replace(_selectBegin, _selectEnd - _selectBegin, uni_str);
-                        textEdited(_selectBegin + 1);
+                        textEdited(_selectBegin + 1, _selectBegin, _selectEnd - _selectBegin, 1);
                     } else {
                         _text.insert(_caret, uni_str);
-                        textEdited(++_caret);
+                        textEdited(_caret + 1, _caret, 0, 1);
                     }
                 }
                 break;
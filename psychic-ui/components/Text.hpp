@@ -176,6 +176,16 @@ namespace psychic_ui {
          */
         void textChanged();
 
+        /**
+         * Same as `textChanged` when the range of the change is known,
+         * only the lines of the paragraphs touched by the change are computed again.
+         *
+         * @param start Index of the change
+         * @param removed Number of code units removed at start
+         * @param inserted Number of code units inserted at start
+         */
+        void textChanged(unsigned int start, unsigned int removed, unsigned int inserted);
+
         /**
          * Called when text was edited, as a shortcut to both
          * `textChanged` and `setCaret` since they have to be called
@@ -185,6 +195,16 @@ namespace psychic_ui {
          */
         void textEdited(unsigned int caret);
 
+        /**
+         * Same as `textEdited` when the range of the edit is known
+         *
+         * @param caret Position the caret should be at after the text was edited
+         * @param start Index of the edit
+         * @param removed Number of code units removed at start
+         * @param inserted Number of code units inserted at start
+         */
+        void textEdited(unsigned int caret, unsigned int start, unsigned int removed, unsigned int inserted);
+
         void handleKey(Key key, Mod mod);
     };
 }
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "psychic-ui/Div.hpp"
+#include "psychic-ui/utils/ExtentTree.hpp"
+
+namespace psychic_ui {
+
+    /**
+     * Data container that only instantiates the items visible in its parent
+     *
+     * Meant to be the content of a Scroller: the parent is the scrolling viewport. Items are
+     * stacked vertically and absolutely positioned from their extents, the container itself
+     * takes the height of every item so the scroll bars reflect the whole list. Only the items
+     * intersecting the viewport, plus `overscan` items on each side, have a div. When scrolling,
+     * the divs of the items leaving the viewport are bound to the items entering it and the
+     * divs that are no longer needed are kept in a pool for later.
+     *
+     * Extents are either fixed, every item div is given the same height, or estimated, the item
+     * divs take their natural height and the estimate is replaced by the measured height of
+     * every item that was laid out.
+     *
+     * @tparam T Item type
+     * @tparam D Item div type
+     */
+    template<class T, class D = Div>
+    class VirtualDataContainer : public Div {
+    public:
+        using ContainerData = std::vector<T>;
+        /**
+         * Create an unbound item div
+         */
+        using CreateCallback = std::function<std::shared_ptr<D>()>;
+        /**
+         * Bind an item div to an item, called for every item that comes into view
+         */
+        using BindCallback = std::function<void(D &, const T &, std::size_t)>;
+
+        /**
+         * @param data Items
+         * @param createDiv Create an item div
+         * @param bindDiv Bind an item div to an item
+         * @param itemExtent Height of an item
+         * @param estimated Whether itemExtent is only an estimate of the height of the items
+         */
+        VirtualDataContainer(
+            const ContainerData &data,
+            CreateCallback createDiv,
+            BindCallback bindDiv,
+            int itemExtent,
+            bool estimated = false
+        );
+
+        const ContainerData &data() const;
+        VirtualDataContainer<T, D> *setData(const ContainerData &data);
+
+        int itemExtent() const;
+        bool estimated() const;
+
+        /**
+         * Change the extent of the items, forgetting the measured extents
+         * @param itemExtent
+         * @param estimated
+         */
+        VirtualDataContainer<T, D> *setItemExtent(int itemExtent, bool estimated = false);
+
+        unsigned int overscan() const;
+
+        /**
+         * Number of items instantiated before and after the viewport
+         * so that scrolling a little doesn't reveal missing items
+         * @param overscan
+         */
+        VirtualDataContainer<T, D> *setOverscan(unsigned int overscan);
+
+        /**
+         * Extents of all the items
+         */
+        const ExtentTree &extents() const;
+
+        /**
+         * Index of the first item with a div
+         */
+        std::size_t firstIndex() const;
+
+        /**
+         * Number of items with a div
+         */
+        std::size_t instantiatedCount() const;
+
+        /**
+         * Div of an item
+         * @param index
+         * @return Item div, nullptr when the item is not instantiated
+         */
+        D *itemDiv(std::size_t index) const;
+
+        /**
+         * Number of unused divs waiting to be recycled
+         */
+        std::size_t poolSize() const;
+
+    protected:
+        void added() override;
+        void removed() override;
+        void layoutUpdated() override;
+
+        /**
+         * Instantiate the items intersecting the viewport, recycling the divs of the others
+         * @param rebind Bind every div again, even if its item is still in view
+         */
+        void updateItems(bool rebind = false);
+
+        /**
+         * Resize the container to the total extent of the items
+         */
+        void updateHeight();
+
+        /**
+         * Position an item div at the offset of its item
+         * @param div
+         * @param index
+         */
+        void place(D &div, std::size_t index);
+
+        ContainerData  _data{};
+        CreateCallback _createDiv{nullptr};
+        BindCallback   _bindDiv{nullptr};
+        int            _itemExtent;
+        bool           _estimated;
+        unsigned int   _overscan{4};
+        ExtentTree     _extents{};
+
+        /**
+         * Divs of the items [_first, _first + _items.size())
+         */
+        std::size_t                     _first{0};
+        std::vector<std::shared_ptr<D>> _items{};
+        std::vector<std::shared_ptr<D>> _pool{};
+
+        std::shared_ptr<SlotBase> _scrolledSlot{nullptr};
+        std::shared_ptr<SlotBase> _resizedSlot{nullptr};
+
+        // Make some of div's stuff protected since we manage our content
+        using Div::add;
+        using Div::remove;
+        using Div::removeAll;
+    };
+
+    template<class T, class D>
+    VirtualDataContainer<T, D>::VirtualDataContainer(
+        const typename VirtualDataContainer<T, D>::ContainerData &data,
+        CreateCallback createDiv,
+        BindCallback bindDiv,
+        const int itemExtent,
+        const bool estimated
+    ) :
+        Div(),
+        _data(data),
+        _createDiv(std::move(createDiv)),
+        _bindDiv(std::move(bindDiv)),
+        _itemExtent(itemExtent),
+        _estimated(estimated) {
+        setTag("VirtualDataContainer");
+        _extents.reset(_data.size(), _itemExtent);
+        updateHeight();
+    }
+
+    template<class T, class D>
+    const typename VirtualDataContainer<T, D>::ContainerData &VirtualDataContainer<T, D>::data() const {
+        return _data;
+    }
+
+    template<class T, class D>
+    VirtualDataContainer<T, D> *VirtualDataContainer<T, D>::setData(const typename VirtualDataContainer<T, D>::ContainerData &data) {
+        if (data != _data) {
+            _data = data;
+            _extents.reset(_data.size(), _itemExtent);
+            updateHeight();
+            updateItems(true);
+        }
+        return this;
+    }
+
+    template<class T, class D>
+    int VirtualDataContainer<T, D>::itemExtent() const {
+        return _itemExtent;
+    }
+
+    template<class T, class D>
+    bool VirtualDataContainer<T, D>::estimated() const {
+        return _estimated;
+    }
+
+    template<class T, class D>
+    VirtualDataContainer<T, D> *VirtualDataContainer<T, D>::setItemExtent(const int itemExtent, const bool estimated) {
+        _itemExtent = itemExtent;
+        _estimated  = estimated;
+        _extents.reset(_data.size(), _itemExtent);
+        updateHeight();
+        for (std::size_t i = 0; i < _items.size(); ++i) {
+            place(*_items[i], _first + i);
+        }
+        updateItems();
+        return this;
+    }
+
+    template<class T, class D>
+    unsigned int VirtualDataContainer<T, D>::overscan() const {
+        return _overscan;
+    }
+
+    template<class T, class D>
+    VirtualDataContainer<T, D> *VirtualDataContainer<T, D>::setOverscan(const unsigned int overscan) {
+        if (overscan != _overscan) {
+            _overscan = overscan;
+            updateItems();
+        }
+        return this;
+    }
+
+    template<class T, class D>
+    const ExtentTree &VirtualDataContainer<T, D>::extents() const {
+        return _extents;
+    }
+
+    template<class T, class D>
+    std::size_t VirtualDataContainer<T, D>::firstIndex() const {
+        return _first;
+    }
+
+    template<class T, class D>
+    std::size_t VirtualDataContainer<T, D>::instantiatedCount() const {
+        return _items.size();
+    }
+
+    template<class T, class D>
+    D *VirtualDataContainer<T, D>::itemDiv(const std::size_t index) const {
+        return index >= _first && index < _first + _items.size() ? _items[index - _first].get() : nullptr;
+    }
+
+    template<class T, class D>
+    std::size_t VirtualDataContainer<T, D>::poolSize() const {
+        return _pool.size();
+    }
+
+    template<class T, class D>
+    void VirtualDataContainer<T, D>::added() {
+        Div::added();
+        // The parent is the viewport, follow it around
+        _scrolledSlot = subscribeTo(_parent->onScrolled, [this](int, int) { updateItems(); });
+        _resizedSlot  = subscribeTo(_parent->onResized, [this](int, int) { updateItems(); });
+        updateItems();
+    }
+
+    template<class T, class D>
+    void VirtualDataContainer<T, D>::removed() {
+        if (_scrolledSlot) {
+            unsubscribeFrom(_scrolledSlot);
+            _scrolledSlot = nullptr;
+        }
+        if (_resizedSlot) {
+            unsubscribeFrom(_resizedSlot);
+            _resizedSlot = nullptr;
+        }
+        Div::removed();
+    }
+
+    template<class T, class D>
+    void VirtualDataContainer<T, D>::layoutUpdated() {
+        Div::layoutUpdated();
+
+        if (!_estimated) {
+            return;
+        }
+
+        // Replace the estimates by what the items actually measure
+        bool changed = false;
+        for (std::size_t i = 0; i < _items.size(); ++i) {
+            if (_items[i]->isLayoutReady()) {
+                changed = _extents.setExtent(_first + i, _items[i]->getHeight()) || changed;
+            }
+        }
+
+        if (changed) {
+            updateHeight();
+            for (std::size_t i = 0; i < _items.size(); ++i) {
+                place(*_items[i], _first + i);
+            }
+            updateItems();
+        }
+    }
+
+    template<class T, class D>
+    void VirtualDataContainer<T, D>::updateItems(const bool rebind) {
+        const std::size_t count = _extents.size();
+        std::size_t       first = 0;
+        std::size_t       last  = 0;
+
+        if (_parent && count > 0) {
+            // Viewport, in our coordinates
+            const int top    = std::max(0, -_parent->scrollY() - _y);
+            const int bottom = -_parent->scrollY() - _y + _parent->getHeight();
+            first = std::min(_extents.indexAt(top), count);
+            last  = bottom > top ? std::min(_extents.indexAt(bottom - 1) + 1, count) : first;
+            first = first > _overscan ? first - _overscan : 0;
+            last  = std::min(last + _overscan, count);
+        }
+
+        if (!rebind && first == _first && last == _first + _items.size()) {
+            return;
+        }
+
+        // Keep the divs of the items still in view, the others are free to be recycled
+        std::vector<std::shared_ptr<D>> items(last - first);
+        std::vector<std::shared_ptr<D>> recycled{};
+        for (std::size_t i = 0; i < _items.size(); ++i) {
+            const std::size_t index = _first + i;
+            if (!rebind && index >= first && index < last) {
+                items[index - first] = std::move(_items[i]);
+            } else {
+                recycled.push_back(std::move(_items[i]));
+            }
+        }
+
+        for (std::size_t index = first; index < last; ++index) {
+            auto &div = items[index - first];
+            if (div) {
+                continue;
+            }
+
+            if (!recycled.empty()) {
+                // Still a child, only needs to move
+                div = std::move(recycled.back());
+                recycled.pop_back();
+            } else if (!_pool.empty()) {
+                div = std::move(_pool.back());
+                _pool.pop_back();
+                add(div);
+            } else {
+                div = _createDiv();
+                div->style()
+                   ->set(position, "absolute")
+                   ->set(left, 0)
+                   ->set(right, 0);
+                add(div);
+            }
+
+            _bindDiv(*div, _data[index], index);
+            place(*div, index);
+        }
+
+        for (auto &div: recycled) {
+            remove(div);
+            _pool.push_back(std::move(div));
+        }
+
+        _first = first;
+        _items = std::move(items);
+    }
+
+    template<class T, class D>
+    void VirtualDataContainer<T, D>::updateHeight() {
+        style()->set(height, _extents.total());
+    }
+
+    template<class T, class D>
+    void VirtualDataContainer<T, D>::place(D &div, const std::size_t index) {
+        div.style()
+           ->set(top, _extents.offset(index))
+           ->set(height, _estimated ? Style::Auto : _itemExtent);
+    }
+
+}
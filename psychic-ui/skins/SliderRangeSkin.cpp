@@ -102,6 +102,7 @@ namespace psychic_ui {
 
     void SliderRangeSkin::setValue(const float value) {
         _value = value;
+        invalidateRender();
         if (_value >= 0.5f) {
             addClassName("inverted");
             removeClassName("normal");
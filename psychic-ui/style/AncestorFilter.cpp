@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <limits>
+#include "AncestorFilter.hpp"
+#include "../Div.hpp"
+
+namespace psychic_ui {
+
+    namespace {
+        // Atoms are sequential integers, mix them so that both probes use all of the bits,
+        // salted with the kind of key so that a tag and a class with the same name differ
+        unsigned int hashKey(const std::uint32_t kind, const Atom &atom) {
+            std::uint32_t hash = atom.id() * 2654435761u ^ kind;
+            hash ^= hash >> 15;
+            hash *= 2246822519u;
+            hash ^= hash >> 13;
+            return hash;
+        }
+    }
+
+    unsigned int AncestorFilter::tagKey(const Atom &tag) {
+        return hashKey(0x74616700u, tag);
+    }
+
+    unsigned int AncestorFilter::idKey(const Atom &id) {
+        return hashKey(0x69640000u, id);
+    }
+
+    unsigned int AncestorFilter::classKey(const Atom &className) {
+        return hashKey(0x636c6173u, className);
+    }
+
+    void AncestorFilter::push(const Div *div) {
+        _frames.push_back(_keys.size());
+
+        for (const auto &tag : div->tags()) {
+            _keys.push_back(tagKey(tag));
+        }
+        // Id selectors match either the id or the internal id
+        if (!div->idAtom().empty()) {
+            _keys.push_back(idKey(div->idAtom()));
+        }
+        if (!div->internalIdAtom().empty()) {
+            _keys.push_back(idKey(div->internalIdAtom()));
+        }
+        for (const auto &className : div->classNames()) {
+            _keys.push_back(classKey(className));
+        }
+
+        for (std::size_t i = _frames.back(); i < _keys.size(); ++i) {
+            add(_keys[i]);
+        }
+    }
+
+    void AncestorFilter::pop() {
+        if (_frames.empty()) {
+            return;
+        }
+
+        for (std::size_t i = _frames.back(); i < _keys.size(); ++i) {
+            remove(_keys[i]);
+        }
+        _keys.resize(_frames.back());
+        _frames.pop_back();
+    }
+
+    void AncestorFilter::pushAncestors(const Div *div) {
+        for (const Div *ancestor = div->parent(); ancestor; ancestor = ancestor->parent()) {
+            push(ancestor);
+        }
+    }
+
+    bool AncestorFilter::mayContain(const unsigned int key) const {
+        return _counters[key & keyMask] != 0 && _counters[(key >> keyBits) & keyMask] != 0;
+    }
+
+    bool AncestorFilter::mayContainAll(const std::vector<unsigned int> &keys) const {
+        return std::all_of(
+            keys.cbegin(),
+            keys.cend(),
+            [this](const unsigned int key) { return mayContain(key); }
+        );
+    }
+
+    void AncestorFilter::add(const unsigned int key) {
+        for (const unsigned int slot : {key & keyMask, (key >> keyBits) & keyMask}) {
+            if (_counters[slot] != std::numeric_limits<std::uint8_t>::max()) {
+                ++_counters[slot];
+            }
+        }
+    }
+
+    void AncestorFilter::remove(const unsigned int key) {
+        for (const unsigned int slot : {key & keyMask, (key >> keyBits) & keyMask}) {
+            if (_counters[slot] != std::numeric_limits<std::uint8_t>::max()) {
+                --_counters[slot];
+            }
+        }
+    }
+}
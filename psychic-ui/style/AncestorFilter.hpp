@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../utils/Atom.hpp"
+
+namespace psychic_ui {
+    class Div;
+
+    /**
+     * Counting bloom filter of the tags, ids and classes of the ancestors of the div being styled
+     *
+     * It is maintained while walking down the tree during a style pass so that descendant
+     * selectors requiring an ancestor key that is absent can be rejected without walking
+     * up the parent chain. A negative answer is exact, a positive one still has to be
+     * confirmed by StyleSelector::matches.
+     */
+    class AncestorFilter {
+    public:
+        static unsigned int tagKey(const Atom &tag);
+        static unsigned int idKey(const Atom &id);
+        static unsigned int classKey(const Atom &className);
+
+        /**
+         * Add a div as the new innermost ancestor
+         * @param div
+         */
+        void push(const Div *div);
+
+        /**
+         * Remove the innermost ancestor added with push
+         */
+        void pop();
+
+        /**
+         * Add every ancestor of a div, used when a style pass doesn't start from the root
+         * @param div
+         */
+        void pushAncestors(const Div *div);
+
+        /**
+         * Whether one of the ancestors may have this key
+         * @param key
+         * @return false if no ancestor has the key, true if one might have it
+         */
+        bool mayContain(unsigned int key) const;
+
+        /**
+         * Whether the ancestors may have all of these keys
+         * @param keys
+         * @return false if at least one key is missing from all the ancestors
+         */
+        bool mayContainAll(const std::vector<unsigned int> &keys) const;
+
+    protected:
+        static const unsigned int keyBits = 12;
+        static const unsigned int keyMask = (1u << keyBits) - 1;
+
+        /**
+         * Counters saturate instead of overflowing, a saturated counter is never decremented
+         */
+        std::array<std::uint8_t, 1u << keyBits> _counters{};
+
+        /**
+         * Keys added for every ancestor, so that pop removes exactly what push added
+         */
+        std::vector<unsigned int> _keys{};
+        std::vector<std::size_t>  _frames{};
+
+        void add(unsigned int key);
+        void remove(unsigned int key);
+    };
+}
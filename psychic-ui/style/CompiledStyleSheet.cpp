@@ -0,0 +1,345 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+#include "CompiledStyleSheet.hpp"
+#include "StyleManager.hpp"
+#include "../utils/MappedFile.hpp"
+
+namespace psychic_ui {
+
+    namespace {
+        static_assert(
+            ColorPropertyCount <= 256 && StringPropertyCount <= 256 && FloatPropertyCount <= 256
+            && IntPropertyCount <= 256 && BoolPropertyCount <= 256,
+            "Compiled style sheets store properties on one byte"
+        );
+
+        /**
+         * Appends values in native byte order, the magic number rejects data of another byte order
+         */
+        class Writer {
+        public:
+            std::string data{};
+
+            template<typename T>
+            void write(const T value) {
+                data.append(reinterpret_cast<const char *>(&value), sizeof(T));
+            }
+
+            void write(const std::string &value) {
+                write(static_cast<std::uint32_t>(value.size()));
+                data.append(value);
+            }
+        };
+
+        /**
+         * Bounds checked reads, once a read fails every following read fails too
+         */
+        class Reader {
+        public:
+            Reader(const char *data, const std::size_t size) :
+                _data(data),
+                _size(size) {}
+
+            template<typename T>
+            T read() {
+                T value{};
+                if (_failed || _size - _position < sizeof(T)) {
+                    _failed = true;
+                    return value;
+                }
+                std::memcpy(&value, _data + _position, sizeof(T));
+                _position += sizeof(T);
+                return value;
+            }
+
+            std::string readString() {
+                const auto length = read<std::uint32_t>();
+                if (_failed || _size - _position < length) {
+                    _failed = true;
+                    return "";
+                }
+                std::string value(_data + _position, length);
+                _position += length;
+                return value;
+            }
+
+            bool failed() const {
+                return _failed;
+            }
+
+            void fail() {
+                _failed = true;
+            }
+
+        protected:
+            const char  *_data;
+            std::size_t _size;
+            std::size_t _position{0};
+            bool        _failed{false};
+        };
+
+        /**
+         * Strings are written once and referenced by index
+         */
+        class StringTable {
+        public:
+            std::vector<std::string> strings{};
+
+            std::uint32_t index(const std::string &value) {
+                auto it = _indices.find(value);
+                if (it != _indices.cend()) {
+                    return it->second;
+                }
+                const auto index = static_cast<std::uint32_t>(strings.size());
+                strings.push_back(value);
+                _indices.emplace(value, index);
+                return index;
+            }
+
+        protected:
+            std::unordered_map<std::string, std::uint32_t> _indices{};
+        };
+    }
+
+    const std::uint32_t CompiledStyleSheet::magic   = 0x50535953; // PSYS
+    const std::uint32_t CompiledStyleSheet::version = 2;
+
+    // region Compile
+
+    std::string CompiledStyleSheet::compile(const StyleManager *manager, const std::string &key, const std::uint32_t stamp) {
+        std::unordered_map<const StyleDeclaration *, const std::string *> selectorStrings{};
+        for (const auto &declaration: manager->_declarations) {
+            selectorStrings.emplace(declaration.second.get(), &declaration.first);
+        }
+
+        // In declaration order, loading declares them again in the same order. Not from the
+        // indexes, they don't contain the "*" declaration.
+        const std::vector<const StyleDeclaration *> declarations = manager->declarationsInOrder();
+
+        StringTable strings{};
+        strings.index("");
+        Writer body{};
+        body.write(static_cast<std::uint32_t>(declarations.size()));
+        for (const StyleDeclaration *declaration: declarations) {
+            body.write(strings.index(*selectorStrings[declaration]));
+
+            // Rightmost compound first, like the selector chain
+            std::uint32_t depth = 0;
+            for (const StyleSelector *selector = declaration->selector(); selector; selector = selector->next()) {
+                ++depth;
+            }
+            body.write(depth);
+            for (const StyleSelector *selector = declaration->selector(); selector; selector = selector->next()) {
+                std::uint8_t pseudo = 0;
+                for (const auto &p: selector->_pseudo) {
+                    pseudo = static_cast<std::uint8_t>(pseudo | (1u << p));
+                }
+                body.write(static_cast<std::uint8_t>(selector->_direct));
+                body.write(pseudo);
+                body.write(strings.index(selector->_tag.str()));
+                body.write(strings.index(selector->_id.str()));
+                body.write(static_cast<std::uint32_t>(selector->_classes.size()));
+                for (const auto &className: selector->_classes) {
+                    body.write(strings.index(className.str()));
+                }
+            }
+
+            const Style *style = declaration->style();
+            auto writeValues = [&body](const auto &values, auto writeValue) {
+                body.write(static_cast<std::uint32_t>(values.size()));
+                values.forEach(
+                    [&body, &writeValue](std::size_t property, const auto &value) {
+                        body.write(static_cast<std::uint8_t>(property));
+                        writeValue(value);
+                    }
+                );
+            };
+            writeValues(style->_colorValues, [&body](Color value) { body.write(value); });
+            writeValues(style->_stringValues, [&body, &strings](const std::string *value) { body.write(strings.index(*value)); });
+            writeValues(style->_floatValues, [&body](float value) { body.write(value); });
+            writeValues(style->_intValues, [&body](int value) { body.write(static_cast<std::int32_t>(value)); });
+            writeValues(style->_boolValues, [&body](std::uint8_t value) { body.write(value); });
+        }
+
+        Writer header{};
+        header.write(magic);
+        header.write(version);
+        for (std::size_t count: {ColorPropertyCount, StringPropertyCount, FloatPropertyCount, IntPropertyCount, BoolPropertyCount}) {
+            header.write(static_cast<std::uint32_t>(count));
+        }
+        header.write(key);
+        header.write(stamp);
+        header.write(static_cast<std::uint32_t>(strings.strings.size()));
+        for (const auto &string: strings.strings) {
+            header.write(string);
+        }
+
+        return header.data + body.data;
+    }
+
+    bool CompiledStyleSheet::save(const std::string &compiled, const std::string &path) {
+        // Truncating the file in place would change the pages of the files mapped by load()
+        const std::string temporary = path + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                return false;
+            }
+            file.write(compiled.data(), static_cast<std::streamsize>(compiled.size()));
+            file.close();
+            if (!file) {
+                std::remove(temporary.c_str());
+                return false;
+            }
+        }
+        #if defined(_WIN32)
+        // rename() doesn't replace an existing file there
+        std::remove(path.c_str());
+        #endif
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // endregion
+
+    // region Load
+
+    bool CompiledStyleSheet::load(StyleManager *manager, const std::string &path, const std::string &key, const std::uint32_t stamp) {
+        MappedFile file{path};
+        return file.valid() && load(manager, file.data(), file.size(), key, stamp);
+    }
+
+    bool CompiledStyleSheet::load(StyleManager *manager, const char *data, const std::size_t size, const std::string &key, const std::uint32_t stamp) {
+        // Anything shorter than the magic number and the version is not compiled data at all
+        if (!data || size < 2 * sizeof(std::uint32_t)) {
+            return false;
+        }
+        Reader reader{data, size};
+
+        if (reader.read<std::uint32_t>() != magic || reader.read<std::uint32_t>() != version) {
+            return false;
+        }
+        for (std::size_t count: {ColorPropertyCount, StringPropertyCount, FloatPropertyCount, IntPropertyCount, BoolPropertyCount}) {
+            if (reader.read<std::uint32_t>() != count) {
+                return false;
+            }
+        }
+        if (reader.readString() != key || reader.read<std::uint32_t>() != stamp || reader.failed()) {
+            return false;
+        }
+
+        const auto               stringCount = reader.read<std::uint32_t>();
+        std::vector<std::string> strings{};
+        for (std::uint32_t i = 0; i < stringCount && !reader.failed(); ++i) {
+            strings.push_back(reader.readString());
+        }
+        // The empty string always comes first
+        if (reader.failed() || strings.empty() || !strings.front().empty()) {
+            return false;
+        }
+
+        auto string = [&reader, &strings]() -> const std::string & {
+            const auto index = reader.read<std::uint32_t>();
+            if (index >= strings.size()) {
+                reader.fail();
+                return strings.front();
+            }
+            return strings[index];
+        };
+
+        // Everything is read before anything is declared so that invalid data adds nothing
+        struct Compiled {
+            const std::string              *selectorString;
+            std::unique_ptr<StyleSelector> selector;
+            Style                          style;
+        };
+        std::vector<Compiled> declarations{};
+
+        const auto declarationCount = reader.read<std::uint32_t>();
+        for (std::uint32_t i = 0; i < declarationCount && !reader.failed(); ++i) {
+            Compiled compiled{&string(), nullptr, Style{}};
+
+            const auto     depth = reader.read<std::uint32_t>();
+            StyleSelector *last  = nullptr;
+            for (std::uint32_t d = 0; d < depth && !reader.failed(); ++d) {
+                auto selector = std::make_unique<StyleSelector>();
+                selector->_depth  = static_cast<int>(depth - 1 - d);
+                selector->_direct = reader.read<std::uint8_t>() != 0;
+                const auto pseudo = reader.read<std::uint8_t>();
+                for (int p = focus; p <= lastChild; ++p) {
+                    if (pseudo & (1u << p)) {
+                        selector->_pseudo.insert(static_cast<Pseudo>(p));
+                    }
+                }
+                selector->_tag = string();
+                selector->_id  = string();
+                const auto classCount = reader.read<std::uint32_t>();
+                for (std::uint32_t c = 0; c < classCount && !reader.failed(); ++c) {
+                    selector->_classes.emplace_back(string());
+                }
+
+                StyleSelector *current = selector.get();
+                if (last) {
+                    last->_next = std::move(selector);
+                } else {
+                    compiled.selector = std::move(selector);
+                }
+                last = current;
+            }
+            if (!compiled.selector) {
+                reader.fail();
+                break;
+            }
+            compiled.selector->computeAncestorKeys();
+
+            auto readValues = [&reader](auto &values, std::size_t count, auto readValue) {
+                const auto size = reader.read<std::uint32_t>();
+                for (std::uint32_t v = 0; v < size && !reader.failed(); ++v) {
+                    const auto property = reader.read<std::uint8_t>();
+                    if (property >= count) {
+                        reader.fail();
+                        return;
+                    }
+                    values.set(property, readValue());
+                }
+            };
+            Style &style = compiled.style;
+            readValues(style._colorValues, ColorPropertyCount, [&reader]() { return reader.read<Color>(); });
+            readValues(style._stringValues, StringPropertyCount, [&string]() { return StringPool::intern(string()); });
+            readValues(style._floatValues, FloatPropertyCount, [&reader]() { return reader.read<float>(); });
+            readValues(style._intValues, IntPropertyCount, [&reader]() { return static_cast<int>(reader.read<std::int32_t>()); });
+            readValues(style._boolValues, BoolPropertyCount, [&reader]() { return reader.read<std::uint8_t>(); });
+
+            declarations.push_back(std::move(compiled));
+        }
+        if (reader.failed()) {
+            return false;
+        }
+
+        for (auto &compiled: declarations) {
+            auto existing = manager->_declarations.find(*compiled.selectorString);
+            if (existing != manager->_declarations.cend()) {
+                existing->second->style()->overlay(&compiled.style);
+            } else {
+                // Move the values instead of overlaying them, the declaration is new
+                Style *style = manager->declare(*compiled.selectorString, std::move(compiled.selector));
+                style->_colorValues  = std::move(compiled.style._colorValues);
+                style->_stringValues = std::move(compiled.style._stringValues);
+                style->_floatValues  = std::move(compiled.style._floatValues);
+                style->_intValues    = std::move(compiled.style._intValues);
+                style->_boolValues   = std::move(compiled.style._boolValues);
+            }
+        }
+        manager->_valid = false;
+
+        return true;
+    }
+
+    // endregion
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace psychic_ui {
+    class StyleManager;
+
+    /**
+     * Binary form of the declarations of a style manager
+     *
+     * Selectors are stored already parsed and values already typed, so loading a compiled
+     * style sheet skips the lowercasing, splitting and parsing of every selector string that
+     * declaring the rules with StyleManager::style() costs. Style sheets are still authored
+     * with the StyleSheet API, they are compiled the first time they load, see
+     * StyleManager::loadStyleSheet(compiledPath).
+     *
+     * Every declaration is compiled, the "*" base rule included, in declaration order so that
+     * declarations of equal weight override each other the same way they do when authored. Compiled data is only
+     * valid for the build and the rules that wrote it: the format version, the property counts,
+     * the key and the stamp are checked and data that doesn't match is rejected.
+     */
+    class CompiledStyleSheet {
+    public:
+        /**
+         * Serialize every declaration of a style manager
+         * @param manager
+         * @param key Identifies the style sheet, only data compiled with the same key loads
+         * @param stamp Version of the rules, only data compiled with the same stamp loads
+         * @return Compiled data
+         */
+        static std::string compile(const StyleManager *manager, const std::string &key, std::uint32_t stamp = 0);
+
+        /**
+         * Write compiled data to a file
+         * The data is written next to the file and renamed over it, so the file is never seen
+         * partially written, and files mapped by load() keep the data they mapped.
+         * @param compiled
+         * @param path
+         * @return Whether the file was written
+         */
+        static bool save(const std::string &compiled, const std::string &path);
+
+        /**
+         * Add the declarations of a compiled style sheet file to a manager
+         * The file is memory mapped, nothing is added if it is missing or invalid.
+         * @param manager
+         * @param path
+         * @param key Key the data was compiled with
+         * @param stamp Stamp the data was compiled with
+         * @return Whether the declarations were loaded
+         */
+        static bool load(StyleManager *manager, const std::string &path, const std::string &key, std::uint32_t stamp = 0);
+
+        /**
+         * Add compiled declarations to a manager
+         * Declarations that already exist get the compiled values set onto them, like declaring
+         * the same selector again would. Nothing is added if the data is invalid.
+         * @param manager
+         * @param data
+         * @param size
+         * @param key Key the data was compiled with
+         * @param stamp Stamp the data was compiled with
+         * @return Whether the declarations were loaded
+         */
+        static bool load(StyleManager *manager, const char *data, std::size_t size, const std::string &key, std::uint32_t stamp = 0);
+
+    protected:
+        static const std::uint32_t magic;
+        static const std::uint32_t version;
+    };
+}
@@ -0,0 +1,56 @@
+#include "ResolvedStyle.hpp"
+#include "../utils/YogaUtils.hpp"
+
+namespace psychic_ui {
+
+    namespace {
+        Color firstColor(const Style &style, std::initializer_list<ColorProperty> properties) {
+            for (auto property: properties) {
+                if (style.has(property)) {
+                    return style.get(property);
+                }
+            }
+            return 0x00000000;
+        }
+    }
+
+    void ResolvedStyle::resolve(const Style &style) {
+        // region Layout
+        direction      = YogaDirectionFromString(style.get(psychic_ui::direction), YGDirectionInherit);
+        flexDirection  = YogaFlexDirectionFromString(style.get(psychic_ui::flexDirection), YGFlexDirectionColumn);
+        justifyContent = YogaJustifyFromString(style.get(psychic_ui::justifyContent), YGJustifyFlexStart);
+        alignContent   = YogaAlignFromString(style.get(psychic_ui::alignContent), YGAlignFlexStart);
+        alignItems     = YogaAlignFromString(style.get(psychic_ui::alignItems), YGAlignStretch);
+        alignSelf      = YogaAlignFromString(style.get(psychic_ui::alignSelf), YGAlignAuto);
+        position       = YogaPositionFromString(style.get(psychic_ui::position), YGPositionTypeRelative);
+        flexWrap       = YogaWrapFromString(style.get(psychic_ui::flexWrap), YGWrapNoWrap);
+        overflow       = YogaOverflowFromString(style.get(psychic_ui::overflow), YGOverflowVisible);
+        display        = YogaDisplayFromString(style.get(psychic_ui::display), YGDisplayFlex);
+        // endregion
+
+        // region Paint
+        // Transparent when not set, the property default is opaque black
+        backgroundColor   = style.get(psychic_ui::backgroundColor, 0x00000000);
+        borderColor       = style.get(psychic_ui::borderColor);
+        borderLeftColor   = firstColor(
+            style, {psychic_ui::borderLeftColor, borderHorizontalColor, psychic_ui::borderColor}
+        );
+        borderRightColor  = firstColor(
+            style, {psychic_ui::borderRightColor, borderHorizontalColor, psychic_ui::borderColor}
+        );
+        borderTopColor    = firstColor(
+            style, {psychic_ui::borderTopColor, borderVerticalColor, psychic_ui::borderColor}
+        );
+        borderBottomColor = firstColor(
+            style, {psychic_ui::borderBottomColor, borderVerticalColor, psychic_ui::borderColor}
+        );
+
+        border     = style.get(psychic_ui::border);
+        antiAlias  = style.get(psychic_ui::antiAlias);
+        hasOpacity = style.has(opacity);
+        alpha      = hasOpacity ? (unsigned int) (style.get(opacity) * 255.f) : 255;
+        retained   = style.get(psychic_ui::retained);
+        layer      = style.get(psychic_ui::layer);
+        // endregion
+    }
+}
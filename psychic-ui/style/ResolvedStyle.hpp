@@ -0,0 +1,85 @@
+#pragma once
+
+#include <yoga/Yoga.h>
+#include "Style.hpp"
+
+namespace psychic_ui {
+
+    /**
+     * Computed style values a div uses on every frame, resolved once per restyle
+     *
+     * Layout strings are converted to their Yoga enums and the paint values are resolved
+     * through their fallbacks, so rendering, hit testing and layout updates read plain fields
+     * instead of looking up and comparing strings. Defaults are those of an empty style.
+     */
+    struct ResolvedStyle {
+        // region Layout
+        YGDirection     direction{YGDirectionInherit};
+        YGFlexDirection flexDirection{YGFlexDirectionColumn};
+        YGJustify       justifyContent{YGJustifyFlexStart};
+        YGAlign         alignContent{YGAlignFlexStart};
+        YGAlign         alignItems{YGAlignStretch};
+        YGAlign         alignSelf{YGAlignAuto};
+        YGPositionType  position{YGPositionTypeRelative};
+        YGWrap          flexWrap{YGWrapNoWrap};
+        YGOverflow      overflow{YGOverflowVisible};
+        YGDisplay       display{YGDisplayFlex};
+        // endregion
+
+        // region Paint
+        /**
+         * Transparent when not set
+         */
+        Color backgroundColor{0x00000000};
+        Color borderColor{0x00000000};
+
+        /**
+         * Colors of the individual borders, after falling back to the horizontal or vertical
+         * border color and then to the border color, transparent when none is set
+         */
+        Color borderLeftColor{0x00000000};
+        Color borderRightColor{0x00000000};
+        Color borderTopColor{0x00000000};
+        Color borderBottomColor{0x00000000};
+
+        /**
+         * Undefined (NaN) when not set, like in the style
+         */
+        float border{nanf("undefined")};
+        bool  antiAlias{false};
+
+        /**
+         * Opacity as a paint alpha, only when opacity is set
+         */
+        bool         hasOpacity{false};
+        unsigned int alpha{255};
+
+        /**
+         * The subtree is recorded once and replayed until something in it changes
+         */
+        bool retained{false};
+
+        /**
+         * The subtree is rasterized once into an image composited until something in it changes
+         */
+        bool layer{false};
+        // endregion
+
+        /**
+         * Content is clipped to the div
+         *
+         * Follows the overflow value given to Yoga: overflow strings are not case sensitive, and
+         * an empty or unrecognised overflow is visible and doesn't clip. Before styles were
+         * resolved, drawing compared the raw string with "visible", so these clipped.
+         */
+        bool clips() const {
+            return overflow != YGOverflowVisible;
+        }
+
+        /**
+         * Resolve every value from a computed style
+         * @param style
+         */
+        void resolve(const Style &style);
+    };
+}
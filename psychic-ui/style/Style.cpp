@@ -5,6 +5,51 @@
 
 namespace psychic_ui {
 
+    // region Changes
+
+    namespace {
+        /**
+         * Properties pushed to Yoga by Div::updateLayout, plus the ones text measurement depends on
+         */
+        const std::bitset<StringPropertyCount> layoutStrings = maskOf<StringPropertyCount>(
+            {
+                fontFamily, position, direction, display,
+                justifyContent, flexDirection, alignContent, alignItems, alignSelf,
+                flexWrap, overflow
+            }
+        );
+
+        const std::bitset<FloatPropertyCount> layoutFloats = []() {
+            std::bitset<FloatPropertyCount> mask{};
+            // Every property from flex to borderBottom is a Yoga property
+            for (std::size_t property = flex; property <= borderBottom; ++property) {
+                mask.set(property);
+            }
+            mask.set(fontSize);
+            mask.set(letterSpacing);
+            mask.set(lineHeight);
+            return mask;
+        }();
+    }
+
+    bool StyleChanges::empty() const {
+        return colors.none() && strings.none() && floats.none() && ints.none() && bools.none();
+    }
+
+    bool StyleChanges::affectsLayout() const {
+        return (strings & layoutStrings).any() || (floats & layoutFloats).any();
+    }
+
+    bool StyleChanges::affectsInheritance(const InheritableValues &inheritable) const {
+        return (colors & inheritable.colorMask).any()
+               || (strings & inheritable.stringMask).any()
+               || (floats & inheritable.floatMask).any()
+               || (ints & inheritable.intMask).any()
+               || (bools & inheritable.boolMask).any();
+    }
+
+    // endregion
+
     std::unique_ptr<Style> Style::dummyStyle{std::make_unique<Style>()};
     const float Style::Auto = nanf("auto");
 
@@ -17,11 +62,19 @@ namespace psychic_ui {
 
     Style *Style::overlay(const Style *style) {
         if (style) {
-            doOverlay(style->_colorValues, _colorValues);
-            doOverlay(style->_stringValues, _stringValues);
-            doOverlay(style->_floatValues, _floatValues);
-            doOverlay(style->_intValues, _intValues);
-            doOverlay(style->_boolValues, _boolValues);
+            // Flatten the inherited values of style, its own values take precedence over them
+            if (style->_inherited) {
+                _colorValues.overlay(style->_inherited->_colorValues);
+                _stringValues.overlay(style->_inherited->_stringValues);
+                _floatValues.overlay(style->_inherited->_floatValues);
+                _intValues.overlay(style->_inherited->_intValues);
+                _boolValues.overlay(style->_inherited->_boolValues);
+            }
+            _colorValues.overlay(style->_colorValues);
+            _stringValues.overlay(style->_stringValues);
+            _floatValues.overlay(style->_floatValues);
+            _intValues.overlay(style->_intValues);
+            _boolValues.overlay(style->_boolValues);
 
             // Just assume something changed
             if (_onChanged) {
@@ -33,12 +86,23 @@ namespace psychic_ui {
     }
 
     Style *Style::overlayInheritable(const Style *style, const Div *div) {
+        return overlayInheritable(style, div->inheritableValues());
+    }
+
+    Style *Style::overlayInheritable(const Style *style, const InheritableValues &inheritable) {
         if (style) {
-            doInheritance(style->_colorValues, _colorValues, div->inheritableValues().colorInheritable);
-            doInheritance(style->_stringValues, _stringValues, div->inheritableValues().stringInheritable);
-            doInheritance(style->_floatValues, _floatValues, div->inheritableValues().floatInheritable);
-            doInheritance(style->_intValues, _intValues, div->inheritableValues().intInheritable);
-            doInheritance(style->_boolValues, _boolValues, div->inheritableValues().boolInheritable);
+            if (style->_inherited) {
+                _colorValues.overlay(style->_inherited->_colorValues, inheritable.colorMask);
+                _stringValues.overlay(style->_inherited->_stringValues, inheritable.stringMask);
+                _floatValues.overlay(style->_inherited->_floatValues, inheritable.floatMask);
+                _intValues.overlay(style->_inherited->_intValues, inheritable.intMask);
+                _boolValues.overlay(style->_inherited->_boolValues, inheritable.boolMask);
+            }
+            _colorValues.overlay(style->_colorValues, inheritable.colorMask);
+            _stringValues.overlay(style->_stringValues, inheritable.stringMask);
+            _floatValues.overlay(style->_floatValues, inheritable.floatMask);
+            _intValues.overlay(style->_intValues, inheritable.intMask);
+            _boolValues.overlay(style->_boolValues, inheritable.boolMask);
 
             // Just assume something changed
             if (_onChanged) {
@@ -49,13 +113,75 @@ namespace psychic_ui {
         return this;
     }
 
+    Style *Style::inherit(std::shared_ptr<const Style> inherited) {
+        _inherited = std::move(inherited);
+        if (_inherited) {
+            _colorValues.remove(_inherited->_colorValues.mask());
+            _stringValues.remove(_inherited->_stringValues.mask());
+            _floatValues.remove(_inherited->_floatValues.mask());
+            _intValues.remove(_inherited->_intValues.mask());
+            _boolValues.remove(_inherited->_boolValues.mask());
+        }
+
+        // Just assume something changed
+        if (_onChanged) {
+            _onChanged();
+        }
+
+        return this;
+    }
+
+    const std::shared_ptr<const Style> &Style::inherited() const {
+        return _inherited;
+    }
+
+    std::shared_ptr<const Style>
+    Style::inheritedBlock(const std::shared_ptr<const Style> &parent, const InheritableValues &inheritable) {
+        if (!parent) {
+            return nullptr;
+        }
+
+        const bool overridden = (parent->_colorValues.mask() & inheritable.colorMask).any()
+                                || (parent->_stringValues.mask() & inheritable.stringMask).any()
+                                || (parent->_floatValues.mask() & inheritable.floatMask).any()
+                                || (parent->_intValues.mask() & inheritable.intMask).any()
+                                || (parent->_boolValues.mask() & inheritable.boolMask).any();
+
+        const Style *block    = parent->_inherited.get();
+        const bool  narrower = block && (
+            (block->_colorValues.mask() & ~inheritable.colorMask).any()
+            || (block->_stringValues.mask() & ~inheritable.stringMask).any()
+            || (block->_floatValues.mask() & ~inheritable.floatMask).any()
+            || (block->_intValues.mask() & ~inheritable.intMask).any()
+            || (block->_boolValues.mask() & ~inheritable.boolMask).any()
+        );
+
+        // Nothing new to inherit, share what the parent inherited
+        if (!overridden && !narrower) {
+            return parent->_inherited;
+        }
+
+        auto inherited = makePooled<Style>();
+        inherited->overlayInheritable(parent.get(), inheritable);
+        return inherited;
+    }
+
     Style *Style::defaults(const Style *style) {
         if (style) {
-            doDefaults(style->_colorValues, _colorValues);
-            doDefaults(style->_stringValues, _stringValues);
-            doDefaults(style->_floatValues, _floatValues);
-            doDefaults(style->_intValues, _intValues);
-            doDefaults(style->_boolValues, _boolValues);
+            // Inherited values are not blanks
+            if (_inherited) {
+                _colorValues.overlay(style->_colorValues, ~(_colorValues.mask() | _inherited->_colorValues.mask()));
+                _stringValues.overlay(style->_stringValues, ~(_stringValues.mask() | _inherited->_stringValues.mask()));
+                _floatValues.overlay(style->_floatValues, ~(_floatValues.mask() | _inherited->_floatValues.mask()));
+                _intValues.overlay(style->_intValues, ~(_intValues.mask() | _inherited->_intValues.mask()));
+                _boolValues.overlay(style->_boolValues, ~(_boolValues.mask() | _inherited->_boolValues.mask()));
+            } else {
+                _colorValues.defaults(style->_colorValues);
+                _stringValues.defaults(style->_stringValues);
+                _floatValues.defaults(style->_floatValues);
+                _intValues.defaults(style->_intValues);
+                _boolValues.defaults(style->_boolValues);
+            }
 
             // Just assume something changed
             if (_onChanged) {
@@ -74,29 +200,80 @@ namespace psychic_ui {
         #endif
 
         std::cout << "{" << std::endl;
-        for (auto const &kv : _colorValues) {
-            std::cout << "    " << kv.first << ": " << kv.second << std::endl;
-        }
+        _colorValues.forEach(
+            [](std::size_t property, Color value) {
+                std::cout << "    " << property << ": " << value << std::endl;
+            }
+        );
 
-        for (auto const &kv : _stringValues) {
-            std::cout << "    " << kv.first << ": \"" << kv.second << "\"" << std::endl;
-        }
+        _stringValues.forEach(
+            [](std::size_t property, const std::string *value) {
+                std::cout << "    " << property << ": \"" << *value << "\"" << std::endl;
+            }
+        );
 
-        for (auto const &kv : _floatValues) {
-            std::cout << "    " << kv.first << ": " << kv.second << std::endl;
-        }
+        _floatValues.forEach(
+            [](std::size_t property, float value) {
+                std::cout << "    " << property << ": " << value << std::endl;
+            }
+        );
 
-        for (auto const &kv : _intValues) {
-            std::cout << "    " << kv.first << ": " << kv.second << std::endl;
-        }
+        _intValues.forEach(
+            [](std::size_t property, int value) {
+                std::cout << "    " << property << ": " << value << std::endl;
+            }
+        );
 
-        for (auto const &kv : _boolValues) {
-            std::cout << "    " << kv.first << ": " << (kv.second ? "true" : "false") << std::endl;
-        }
+        _boolValues.forEach(
+            [](std::size_t property, bool value) {
+                std::cout << "    " << property << ": " << (value ? "true" : "false") << std::endl;
+            }
+        );
         std::cout << "}" << std::endl << std::endl;
+
+        if (_inherited) {
+            std::cout << "inherited ";
+            _inherited->trace();
+        }
+    }
+
+    StyleChanges Style::diff(const Style &other) const {
+        const Style  *mine   = _inherited.get();
+        const Style  *theirs = other._inherited.get();
+        StyleChanges changes{};
+        changes.colors  = _colorValues.difference(
+            other._colorValues,
+            mine ? &mine->_colorValues : nullptr,
+            theirs ? &theirs->_colorValues : nullptr
+        );
+        changes.strings = _stringValues.difference(
+            other._stringValues,
+            mine ? &mine->_stringValues : nullptr,
+            theirs ? &theirs->_stringValues : nullptr
+        );
+        changes.floats  = _floatValues.difference(
+            other._floatValues,
+            mine ? &mine->_floatValues : nullptr,
+            theirs ? &theirs->_floatValues : nullptr
+        );
+        changes.ints    = _intValues.difference(
+            other._intValues,
+            mine ? &mine->_intValues : nullptr,
+            theirs ? &theirs->_intValues : nullptr
+        );
+        changes.bools   = _boolValues.difference(
+            other._boolValues,
+            mine ? &mine->_boolValues : nullptr,
+            theirs ? &theirs->_boolValues : nullptr
+        );
+        return changes;
     }
 
     bool Style::operator==(const Style &other) const {
+        // Compare what get() returns, the same value can be set or inherited
+        if (_inherited || other._inherited) {
+            return diff(other).empty();
+        }
         return _colorValues == other._colorValues
                && _stringValues == other._stringValues
                && _floatValues == other._floatValues
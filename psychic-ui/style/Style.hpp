@@ -1,38 +1,47 @@
 #pragma once
 
+#include <bitset>
 #include <cmath>
 #include <unordered_map>
 #include <map>
 #include <vector>
 #include <string>
 #include <functional>
+#include <initializer_list>
+#include <memory>
 #include <SkTypeface.h>
 #include <map>
 #include <iostream>
 #include "psychic-ui/psychic-ui.hpp"
+#include "StyleValues.hpp"
+#include "../utils/ObjectPool.hpp"
 
-#define PSYCHIC_STYLE_PROPERTY(type, values, name, defaultValue)                                                       \
+#define PSYCHIC_STYLE_PROPERTY(type, values, name, count, defaultValue)                                                \
 public:                                                                                                                \
 type get(values property) const {                                                                                      \
-    auto search = _##name##Values.find(property);                                                                      \
-    if (search != _##name##Values.cend()) {                                                                            \
-        return search->second;                                                                                         \
+    auto value = _##name##Values.find(property);                                                                       \
+    if (!value && _inherited) {                                                                                        \
+        value = _inherited->_##name##Values.find(property);                                                            \
+    }                                                                                                                  \
+    if (value) {                                                                                                       \
+        return StyleStorage<type>::load(*value);                                                                       \
     } else {                                                                                                           \
         return defaultValue;                                                                                           \
     }                                                                                                                  \
 }                                                                                                                      \
 type get(values property, type fallback) const {                                                                       \
-    auto search = _##name##Values.find(property);                                                                      \
-    if (search != _##name##Values.cend()) {                                                                            \
-        return search->second;                                                                                         \
+    auto value = _##name##Values.find(property);                                                                       \
+    if (!value && _inherited) {                                                                                        \
+        value = _inherited->_##name##Values.find(property);                                                            \
+    }                                                                                                                  \
+    if (value) {                                                                                                       \
+        return StyleStorage<type>::load(*value);                                                                       \
     } else {                                                                                                           \
         return fallback;                                                                                               \
     }                                                                                                                  \
 }                                                                                                                      \
 Style * set(values property, type value) {                                                                             \
-    auto search = _##name##Values.find(property);                                                                      \
-    if (search == _##name##Values.cend() || search->second != value) {                                                 \
-        _##name##Values[property] = value;                                                                             \
+    if (_##name##Values.set(property, StyleStorage<type>::store(value))) {                                             \
         if (_onChanged) {                                                                                              \
             _onChanged();                                                                                              \
         }                                                                                                              \
@@ -40,10 +49,10 @@ Style * set(values property, type value) {
     return this;                                                                                                       \
 }                                                                                                                      \
 bool has(values property) const {                                                                                      \
-    return _##name##Values.find(property) != _##name##Values.cend();                                                   \
+    return _##name##Values.has(property) || (_inherited && _inherited->_##name##Values.has(property));                 \
 }                                                                                                                      \
 protected:                                                                                                             \
-std::unordered_map<values, type, std::hash<int>> _##name##Values{};                                                    \
+StyleValues<StyleStorage<type>::Stored, count> _##name##Values{};                                                      \
 
 
 namespace psychic_ui {
@@ -76,6 +85,8 @@ namespace psychic_ui {
         selectionBackgroundColor,
         contentBackgroundColor // Background color for components that display with an inset "well" (text input, combo boxes, some buttons)
     };
+    // Keep in sync with the last property of the enum
+    constexpr std::size_t ColorPropertyCount = contentBackgroundColor + 1;
 
     enum StringProperty {
         // Yoga/Flex
@@ -87,6 +98,7 @@ namespace psychic_ui {
             skin,
             orientation // For sliders
     };
+    constexpr std::size_t StringPropertyCount = orientation + 1;
 
     enum FloatProperty {
         // Yoga/Flex
@@ -113,42 +125,97 @@ namespace psychic_ui {
             borderRadius, borderRadiusTop, borderRadiusBottom, borderRadiusLeft, borderRadiusRight,
             borderRadiusTopLeft, borderRadiusTopRight, borderRadiusBottomLeft, borderRadiusBottomRight,
     };
+    constexpr std::size_t FloatPropertyCount = borderRadiusBottomRight + 1;
 
     enum IntProperty {
         // Custom
             cursor,
             gap
     };
+    constexpr std::size_t IntPropertyCount = gap + 1;
 
     enum BoolProperty {
         // Custom
             antiAlias,
             textAntiAlias,
-            visible
+            visible,
+            retained,
+            layer
     };
+    constexpr std::size_t BoolPropertyCount = layer + 1;
 
+    /**
+     * Mask with the bits of the given properties set
+     * @tparam N Property count of the property type
+     * @param properties
+     */
+    template<std::size_t N, class T>
+    std::bitset<N> maskOf(std::initializer_list<T> properties) {
+        std::bitset<N> mask{};
+        for (auto property : properties) {
+            mask.set(property);
+        }
+        return mask;
+    }
+
+    /**
+     * Properties a div inherits from its parent, one mask per property type
+     * Defined once per Div class as a static constant, so they can be compared by address.
+     */
     struct InheritableValues {
-        const std::vector<ColorProperty>  colorInheritable;
-        const std::vector<StringProperty> stringInheritable;
-        const std::vector<FloatProperty>  floatInheritable;
-        const std::vector<IntProperty>    intInheritable;
-        const std::vector<BoolProperty>   boolInheritable;
+        const std::bitset<ColorPropertyCount>  colorMask;
+        const std::bitset<StringPropertyCount> stringMask;
+        const std::bitset<FloatPropertyCount>  floatMask;
+        const std::bitset<IntPropertyCount>    intMask;
+        const std::bitset<BoolPropertyCount>   boolMask;
 
         InheritableValues(
-            std::vector<ColorProperty> colorInherit,
-            std::vector<StringProperty> stringInherit,
-            std::vector<FloatProperty> floatInherit,
-            std::vector<IntProperty> intInherit,
-            std::vector<BoolProperty> boolInherit
-        ) : colorInheritable(colorInherit),
-            stringInheritable(stringInherit),
-            floatInheritable(floatInherit),
-            intInheritable(intInherit),
-            boolInheritable(boolInherit) {}
+            std::initializer_list<ColorProperty> colorInherit,
+            std::initializer_list<StringProperty> stringInherit,
+            std::initializer_list<FloatProperty> floatInherit,
+            std::initializer_list<IntProperty> intInherit,
+            std::initializer_list<BoolProperty> boolInherit
+        ) : colorMask(maskOf<ColorPropertyCount>(colorInherit)),
+            stringMask(maskOf<StringPropertyCount>(stringInherit)),
+            floatMask(maskOf<FloatPropertyCount>(floatInherit)),
+            intMask(maskOf<IntPropertyCount>(intInherit)),
+            boolMask(maskOf<BoolPropertyCount>(boolInherit)) {}
+    };
 
+    /**
+     * Properties that differ between two computed styles
+     *
+     * Used after a restyle to only do the work the changes require: a paint-only change
+     * (colors, opacity, etc.) is repainted without touching Yoga, a layout change is pushed
+     * to the Yoga node and an inherited change restyles the children inheriting it.
+     */
+    struct StyleChanges {
+        std::bitset<ColorPropertyCount>  colors{};
+        std::bitset<StringPropertyCount> strings{};
+        std::bitset<FloatPropertyCount>  floats{};
+        std::bitset<IntPropertyCount>    ints{};
+        std::bitset<BoolPropertyCount>   bools{};
+
+        /**
+         * Nothing changed, there is nothing to update nor repaint
+         */
+        bool empty() const;
+
+        /**
+         * Properties used by the layout changed
+         */
+        bool affectsLayout() const;
+
+        /**
+         * Properties inherited by a div changed
+         * @param inheritable Inheritable values of the div
+         */
+        bool affectsInheritance(const InheritableValues &inheritable) const;
     };
 
     class Style {
+        friend class CompiledStyleSheet;
+
     public:
         /**
          * Dummy style is used when we don't want to disrupt the styling code by having to
@@ -163,6 +230,16 @@ namespace psychic_ui {
         explicit Style(const Style *fromStyle);
         explicit Style(const std::function<void()> &onChanged);
 
+        // Every div owns a few styles and restyles compute new ones, keep them pooled
+
+        static void *operator new(std::size_t size) {
+            return ObjectPool::allocate(size);
+        }
+
+        static void operator delete(void *style, std::size_t size) {
+            ObjectPool::deallocate(style, size);
+        }
+
         /**
          * Add all values from style onto this
          * @param style
@@ -174,6 +251,32 @@ namespace psychic_ui {
          * @param style
          */
         Style *overlayInheritable(const Style *style, const Div *div);
+        Style *overlayInheritable(const Style *style, const InheritableValues &inheritable);
+
+        /**
+         * Inherit the values of a shared block instead of copying them
+         * Values of this style that the block also sets are dropped, inherited values take
+         * precedence over them, but values set on this style afterwards override the block.
+         * @param inherited Block of inherited values, from inheritedBlock()
+         */
+        Style *inherit(std::shared_ptr<const Style> inherited);
+
+        /**
+         * Shared block of values inherited by this style, nullptr when nothing is inherited
+         */
+        const std::shared_ptr<const Style> &inherited() const;
+
+        /**
+         * Block of values a child inherits from its parent's computed style
+         *
+         * When the parent doesn't set any of the inheritable properties itself, the child
+         * inherits exactly what the parent inherited and the parent's block is returned, so
+         * an inherited value is shared by the whole subtree until a div overrides it.
+         * @param parent Computed style of the parent
+         * @param inheritable Inheritable values of the child
+         */
+        static std::shared_ptr<const Style>
+        inheritedBlock(const std::shared_ptr<const Style> &parent, const InheritableValues &inheritable);
 
         /**
          * Fill empty properties in this with values from style
@@ -181,45 +284,27 @@ namespace psychic_ui {
          */
         Style *defaults(const Style *style);
 
+        /**
+         * Properties that differ between this and another style
+         * @param other
+         */
+        StyleChanges diff(const Style &other) const;
+
         bool operator==(const Style &other) const;
         bool operator!=(const Style &other) const;
 
         void trace() const;
 
     protected:
-        std::function<void()> _onChanged{nullptr};
-
-        template<class T>
-        inline static void doOverlay(const T &from, T &onto) {
-            for (auto const &kv : from) {
-                onto[kv.first] = kv.second;
-            }
-        }
-
-        template<class T>
-        inline static void doInheritance(const T &from, T &onto, const std::vector<typename T::key_type> &inheritable) {
-            for (auto const &kv : from) {
-                if (std::find(inheritable.cbegin(), inheritable.cend(), kv.first) != inheritable.cend()) {
-                    onto[kv.first] = kv.second;
-                }
-            }
-        }
-
-        template<class T>
-        inline static void doDefaults(const T &from, T &onto) {
-            for (auto const &kv : from) {
-                if (onto.find(kv.first) == onto.cend()) {
-                    onto[kv.first] = kv.second;
-                }
-            }
-        }
+        std::function<void()>        _onChanged{nullptr};
+        std::shared_ptr<const Style> _inherited{nullptr};
 
         // Macro stuff, don't put anything below, it'll end up protected
-    PSYCHIC_STYLE_PROPERTY(Color, ColorProperty, color, 0xFF000000);
-    PSYCHIC_STYLE_PROPERTY(std::string, StringProperty, string, "");
-    PSYCHIC_STYLE_PROPERTY(float, FloatProperty, float, nanf("undefined"));
-    PSYCHIC_STYLE_PROPERTY(int, IntProperty, int, 0);
-    PSYCHIC_STYLE_PROPERTY(bool, BoolProperty, bool, false);
+    PSYCHIC_STYLE_PROPERTY(Color, ColorProperty, color, ColorPropertyCount, 0xFF000000);
+    PSYCHIC_STYLE_PROPERTY(std::string, StringProperty, string, StringPropertyCount, "");
+    PSYCHIC_STYLE_PROPERTY(float, FloatProperty, float, FloatPropertyCount, nanf("undefined"));
+    PSYCHIC_STYLE_PROPERTY(int, IntProperty, int, IntPropertyCount, 0);
+    PSYCHIC_STYLE_PROPERTY(bool, BoolProperty, bool, BoolPropertyCount, false);
 
         #ifdef DEBUG_STYLES
     public:
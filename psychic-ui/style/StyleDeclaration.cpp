@@ -5,9 +5,10 @@ namespace psychic_ui {
     StyleDeclaration::StyleDeclaration(std::unique_ptr<StyleSelector> selector) :
         StyleDeclaration(std::move(selector), nullptr) {}
 
-    StyleDeclaration::StyleDeclaration(std::unique_ptr<StyleSelector> selector, const std::function<void()> &onChanged) :
+    StyleDeclaration::StyleDeclaration(std::unique_ptr<StyleSelector> selector, const std::function<void()> &onChanged, std::size_t order) :
         _selector(std::move(selector)),
-        _style(std::make_unique<Style>(onChanged)) {
+        _style(std::make_unique<Style>(onChanged)),
+        _order(order) {
         // Compute weight
         _weight = _selector->weight();
     }
@@ -23,4 +24,8 @@ namespace psychic_ui {
     int StyleDeclaration::weight() const {
         return _weight;
     }
+
+    std::size_t StyleDeclaration::order() const {
+        return _order;
+    }
 }
@@ -11,7 +11,7 @@ namespace psychic_ui {
     class StyleDeclaration {
     public:
         explicit StyleDeclaration(std::unique_ptr<StyleSelector> selector);
-        StyleDeclaration(std::unique_ptr<StyleSelector> selector, const std::function<void()> &onChanged);
+        StyleDeclaration(std::unique_ptr<StyleSelector> selector, const std::function<void()> &onChanged, std::size_t order = 0);
         const StyleSelector *selector() const;
         Style *style() const;
 
@@ -20,10 +20,18 @@ namespace psychic_ui {
          * @return int
          */
         int weight() const;
+
+        /**
+         * Position of the declaration in its manager, among declarations of the same weight
+         * the last declared one wins
+         * @return std::size_t
+         */
+        std::size_t order() const;
     protected:
         const std::unique_ptr<StyleSelector> _selector{nullptr};
         std::unique_ptr<Style>               _style{nullptr};
         int                                  _weight{0};
+        std::size_t                          _order{0};
 
         #ifdef DEBUG_STYLES
     public:
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include "StyleManager.hpp"
 #include "../Div.hpp"
@@ -18,6 +19,18 @@ namespace psychic_ui {
         _fonts.clear();
         _skins.clear();
         _declarations.clear();
+        _ownedDeclarations.clear();
+        _declarationCount = 0;
+        _idIndex.clear();
+        _classIndex.clear();
+        _tagIndex.clear();
+        _universalIndex.clear();
+        _pseudoMask = 0;
+        _ancestorPseudoMask = 0;
+        _subjectClasses.clear();
+        _ancestorClasses.clear();
+        _subjectIds.clear();
+        _ancestorIds.clear();
         _valid = false;
     }
     
@@ -54,29 +67,231 @@ namespace psychic_ui {
                 std::cerr << "Invalid selector: \"" << selectorString << "\", returning dummy style.";
                 return Style::dummyStyle.get();
             }
+            return declare(std::move(selectorString), std::move(selector));
+        }
+    }
 
-            _declarations[selectorString] = std::make_unique<StyleDeclaration>(
-                std::move(selector),
-                [this]() { _valid = false; }
-            );
+    Style *StyleManager::declare(std::string selectorString, std::unique_ptr<StyleSelector> selector) {
+        auto declaration = std::make_unique<StyleDeclaration>(
+            std::move(selector),
+            [this]() { _valid = false; },
+            _declarationCount++
+        );
 
-            #ifdef DEBUG_STYLES
-            _declarations[selectorString]->selectorString = selectorString;
-            #endif
+        #ifdef DEBUG_STYLES
+        declaration->selectorString = selectorString;
+        #endif
+
+        indexDeclaration(declaration.get());
+
+        return (_declarations[std::move(selectorString)] = std::move(declaration))->style();
+    }
+
+    Style *StyleManager::style(std::string selectorString, const Div *owner) {
+        std::transform(selectorString.begin(), selectorString.end(), selectorString.begin(), ::tolower);
+        const bool existing = _declarations.find(selectorString) != _declarations.cend();
+        Style      *s       = style(selectorString);
+        if (!existing && s != Style::dummyStyle.get()) {
+            _ownedDeclarations[owner].push_back(std::move(selectorString));
+        }
+        return s;
+    }
+
+    void StyleManager::release(const Div *owner) {
+        auto owned = _ownedDeclarations.find(owner);
+        if (owned == _ownedDeclarations.cend()) {
+            return;
+        }
+        for (const auto &selectorString: owned->second) {
+            auto declaration = _declarations.find(selectorString);
+            if (declaration != _declarations.cend()) {
+                unindexDeclaration(declaration->second.get());
+                _declarations.erase(declaration);
+            }
+        }
+        _ownedDeclarations.erase(owned);
+        // Computed styles could come from the retired declarations
+        _valid = false;
+    }
+
+    std::vector<const StyleDeclaration *> StyleManager::declarationsInOrder() const {
+        std::vector<const StyleDeclaration *> declarations{};
+        declarations.reserve(_declarations.size());
+        for (const auto &declaration: _declarations) {
+            declarations.push_back(declaration.second.get());
+        }
+        std::sort(
+            declarations.begin(), declarations.end(), [](const StyleDeclaration *a, const StyleDeclaration *b) {
+                return a->order() < b->order();
+            }
+        );
+        return declarations;
+    }
+
+    void StyleManager::indexDeclaration(StyleDeclaration *declaration) {
+        // The selector we get is the rightmost one, the one that has to match the component itself
+        const StyleSelector *selector = declaration->selector();
+        if (!selector->id().empty()) {
+            _idIndex[selector->id()].push_back(declaration);
+        } else if (!selector->classes().empty()) {
+            _classIndex[selector->classes().front()].push_back(declaration);
+        } else if (selector->tag() == "*") {
+            // Never matched as a tag, the "*" declaration is the base of every computed style
+        } else if (!selector->tag().empty()) {
+            _tagIndex[selector->tag()].push_back(declaration);
+        } else {
+            _universalIndex.push_back(declaration);
+        }
+
+        for (const auto &pseudo: selector->pseudo()) {
+            _pseudoMask |= 1u << pseudo;
+        }
+        _subjectClasses.insert(selector->classes().cbegin(), selector->classes().cend());
+        if (!selector->id().empty()) {
+            _subjectIds.insert(selector->id());
+        }
+
+        for (const StyleSelector *ancestor = selector->next(); ancestor; ancestor = ancestor->next()) {
+            for (const auto &pseudo: ancestor->pseudo()) {
+                _ancestorPseudoMask |= 1u << pseudo;
+            }
+            _ancestorClasses.insert(ancestor->classes().cbegin(), ancestor->classes().cend());
+            if (!ancestor->id().empty()) {
+                _ancestorIds.insert(ancestor->id());
+            }
+        }
+    }
+
+    namespace {
+        void unindex(std::vector<StyleDeclaration *> &bucket, const StyleDeclaration *declaration) {
+            bucket.erase(std::remove(bucket.begin(), bucket.end(), declaration), bucket.end());
+        }
+
+        template<typename Index>
+        void unindex(Index &index, const Atom &key, const StyleDeclaration *declaration) {
+            auto bucket = index.find(key);
+            if (bucket != index.end()) {
+                unindex(bucket->second, declaration);
+                if (bucket->second.empty()) {
+                    index.erase(bucket);
+                }
+            }
+        }
+
+        void eraseOne(std::unordered_multiset<Atom> &set, const Atom &atom) {
+            auto it = set.find(atom);
+            if (it != set.end()) {
+                set.erase(it);
+            }
+        }
+    }
+
+    void StyleManager::unindexDeclaration(StyleDeclaration *declaration) {
+        // Same bucket selection as indexDeclaration
+        const StyleSelector *selector = declaration->selector();
+        if (!selector->id().empty()) {
+            unindex(_idIndex, selector->id(), declaration);
+        } else if (!selector->classes().empty()) {
+            unindex(_classIndex, selector->classes().front(), declaration);
+        } else if (selector->tag() == "*") {
+            // Not indexed
+        } else if (!selector->tag().empty()) {
+            unindex(_tagIndex, selector->tag(), declaration);
+        } else {
+            unindex(_universalIndex, declaration);
+        }
 
-            return _declarations[selectorString]->style();
+        // Pseudo class masks are kept, they can only cause unneeded invalidations
+        for (const auto &className: selector->classes()) {
+            eraseOne(_subjectClasses, className);
+        }
+        if (!selector->id().empty()) {
+            eraseOne(_subjectIds, selector->id());
+        }
+        for (const StyleSelector *ancestor = selector->next(); ancestor; ancestor = ancestor->next()) {
+            for (const auto &className: ancestor->classes()) {
+                eraseOne(_ancestorClasses, className);
+            }
+            if (!ancestor->id().empty()) {
+                eraseOne(_ancestorIds, ancestor->id());
+            }
         }
     }
 
-    std::unique_ptr<Style> StyleManager::computeStyle(const Div *component) {
-        std::vector<std::pair<int, StyleDeclaration *>> directMatches;
+    std::vector<std::pair<int, StyleDeclaration *>>
+    StyleManager::matchingDeclarations(const Div *component, const AncestorFilter *filter) const {
+        std::vector<std::pair<int, StyleDeclaration *>> matches;
+
+        auto test = [&matches, component, filter](const DeclarationBucket &bucket) {
+            for (const auto &declaration: bucket) {
+                const StyleSelector *selector = declaration->selector();
+                // Quick reject descendant selectors before walking up the parents
+                if (filter && !filter->mayContainAll(selector->ancestorKeys())) {
+                    continue;
+                }
+                if (selector->matches(component)) {
+                    matches.emplace_back(declaration->weight(), declaration);
+                }
+            }
+        };
 
+        auto testIndex = [&test](const DeclarationIndex &index, const Atom &key) {
+            auto bucket = index.find(key);
+            if (bucket != index.cend()) {
+                test(bucket->second);
+            }
+        };
+
+        // Same as in the selector matching, ids match either the id or the internal id
+        if (!component->idAtom().empty()) {
+            testIndex(_idIndex, component->idAtom());
+        }
+        if (!component->internalIdAtom().empty() && component->internalIdAtom() != component->idAtom()) {
+            testIndex(_idIndex, component->internalIdAtom());
+        }
+
+        for (const auto &className: component->classNames()) {
+            testIndex(_classIndex, className);
+        }
+
+        const auto &tags = component->tags();
+        for (auto tag = tags.cbegin(); tag != tags.cend(); ++tag) {
+            // Subclasses could repeat a tag, don't match the same declarations twice
+            if (std::find(tags.cbegin(), tag, *tag) == tag) {
+                testIndex(_tagIndex, *tag);
+            }
+        }
+
+        test(_universalIndex);
+
+        // Candidates come bucket by bucket, sort them by weight then declaration order,
+        // heaviest and then latest overlaid last
+        std::sort(
+            matches.begin(), matches.end(), [](const auto &a, const auto &b) {
+                return a.first != b.first ? a.first < b.first : a.second->order() < b.second->order();
+            }
+        );
+
+        return matches;
+    }
+
+    std::unique_ptr<Style>
+    StyleManager::computeStyle(const Div *component, const AncestorFilter *filter, const Div *sibling) const {
         // Start with global values
-        auto s = std::make_unique<Style>(style("*"));
+        auto universal = _declarations.find("*");
+        auto s         = universal != _declarations.cend()
+                         ? std::make_unique<Style>(universal->second->style())
+                         : std::make_unique<Style>();
 
-        // Apply inherited values
+        // Apply inherited values, they are shared with the siblings and the parent instead of being copied
         if (component->_parent) {
-            s->overlayInheritable(component->_parent->_computedStyle.get(), component);
+            const InheritableValues &inheritable = component->inheritableValues();
+            if (sibling && sibling->_computedStyle && sibling->_computedStyle->inherited()
+                && &sibling->inheritableValues() == &inheritable) {
+                s->inherit(sibling->_computedStyle->inherited());
+            } else {
+                s->inherit(Style::inheritedBlock(component->_parent->_computedStyle, inheritable));
+            }
 
             #ifdef DEBUG_STYLES
             s->declarations.insert(
@@ -87,22 +302,8 @@ namespace psychic_ui {
             #endif
         }
 
-        // Get Direct matches
-        for (const auto &declaration: _declarations) {
-            if (declaration.second->selector()->matches(component)) {
-                directMatches.emplace_back(declaration.second->weight(), declaration.second.get());
-            }
-        }
-
-        // Sort direct matches by weight, heaviest overlaid last
-        std::sort(
-            directMatches.begin(), directMatches.end(), [](const auto &a, const auto &b) {
-                return a.first < b.first;
-            }
-        );
-
         // Apply direct matches
-        for (const auto &directMatch: directMatches) {
+        for (const auto &directMatch: matchingDeclarations(component, filter)) {
             s->overlay(directMatch.second->style());
 
             #ifdef DEBUG_STYLES
@@ -120,4 +321,88 @@ namespace psychic_ui {
         return s;
     }
 
+    bool StyleManager::canShareStyle(const Div *component, const Div *sibling) const {
+        // Siblings inherit from the same parent style and match the same ancestor selectors
+        if (sibling == component || !component->_parent || sibling->_parent != component->_parent) {
+            return false;
+        }
+
+        if (sibling->_styleDirty || !sibling->_computedStyle) {
+            return false;
+        }
+
+        // A local manager override changes the declarations that apply
+        if (component->_styleManager != sibling->_styleManager) {
+            return false;
+        }
+
+        // Declarations targeting an id only apply to one of them
+        for (const Div *div: {component, sibling}) {
+            if ((!div->_id.empty() && _idIndex.find(div->_id) != _idIndex.cend())
+                || (!div->_internalIdAtom.empty() && _idIndex.find(div->_internalIdAtom) != _idIndex.cend())) {
+                return false;
+            }
+        }
+
+        // Only the pseudo classes used by the declarations make a difference
+        return ((component->_computedPseudoState ^ sibling->_computedPseudoState) & _pseudoMask) == 0
+               && component->_tags == sibling->_tags
+               && component->_classNames == sibling->_classNames
+               && &component->inheritableValues() == &sibling->inheritableValues()
+               && *component->_inlineStyle == *sibling->_inlineStyle
+               && *component->_defaultStyle == *sibling->_defaultStyle;
+    }
+
+    unsigned int StyleManager::pseudoState(const Div *component) {
+        unsigned int state = 0;
+        if (component->focusEnabled() && component->focused()) {
+            state |= 1u << focus;
+        }
+        if (component->mouseOver()) {
+            state |= 1u << hover;
+        }
+        if (component->active()) {
+            state |= 1u << active;
+        }
+        if (!component->enabled()) {
+            state |= 1u << disabled;
+        }
+        if (component->childCount() == 0) {
+            state |= 1u << empty;
+        }
+        // NOTE: Children are stored in reverse order
+        const Div *parent = component->_parent;
+        if (parent && !parent->_children.empty()) {
+            if (parent->_children.back().get() == component) {
+                state |= 1u << firstChild;
+            }
+            if (parent->_children.front().get() == component) {
+                state |= 1u << lastChild;
+            }
+        }
+        return state;
+    }
+
+    StyleInvalidation StyleManager::invalidation(const Pseudo pseudo) const {
+        if (_ancestorPseudoMask & (1u << pseudo)) {
+            return StyleInvalidation::Subtree;
+        }
+        return (_pseudoMask & (1u << pseudo)) ? StyleInvalidation::Self : StyleInvalidation::None;
+    }
+
+    StyleInvalidation StyleManager::classInvalidation(const Atom &className) const {
+        if (_ancestorClasses.find(className) != _ancestorClasses.cend()) {
+            return StyleInvalidation::Subtree;
+        }
+        return _subjectClasses.find(className) != _subjectClasses.cend()
+               ? StyleInvalidation::Self
+               : StyleInvalidation::None;
+    }
+
+    StyleInvalidation StyleManager::idInvalidation(const Atom &id) const {
+        if (_ancestorIds.find(id) != _ancestorIds.cend()) {
+            return StyleInvalidation::Subtree;
+        }
+        return _subjectIds.find(id) != _subjectIds.cend() ? StyleInvalidation::Self : StyleInvalidation::None;
+    }
 }
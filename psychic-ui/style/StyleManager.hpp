@@ -1,12 +1,18 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <string>
 #include <memory>
 #include <functional>
 #include <type_traits>
+#include <typeinfo>
+#include <iostream>
 #include "psychic-ui/psychic-ui.hpp"
 #include "psychic-ui/utils/Hatcher.hpp"
+#include "AncestorFilter.hpp"
+#include "CompiledStyleSheet.hpp"
 #include "Style.hpp"
 #include "StyleSelector.hpp"
 #include "StyleSheet.hpp"
@@ -22,7 +28,29 @@ namespace psychic_ui {
     using SkinType = Hatcher<std::shared_ptr<internal::SkinBase>>;
     using SkinMaker = std::shared_ptr<SkinType>;
 
+    /**
+     * What has to be restyled after a change of a div's state, classes or id
+     */
+    enum class StyleInvalidation {
+        /**
+         * No declaration uses what changed
+         */
+        None,
+        /**
+         * Only the div itself can match different declarations
+         * Its children are restyled if the values they inherit change
+         */
+        Self,
+        /**
+         * Declarations use what changed on an ancestor, the whole subtree can match different declarations
+         */
+        Subtree
+    };
+
     class StyleManager {
+        friend class CompiledStyleSheet;
+        friend class Div;
+
     public:
         static std::shared_ptr<StyleManager> instance;
         static std::shared_ptr<StyleManager> getInstance();
@@ -37,7 +65,45 @@ namespace psychic_ui {
             if (reset) {
                 this->reset();
             }
-            std::make_unique<T>()->load(this);
+            auto sheet = std::make_unique<T>();
+            sheet->loadResources(this);
+            sheet->load(this);
+            _valid = false;
+        }
+
+        /**
+         * Load a style sheet through a compiled style sheet file
+         *
+         * The declarations are read from the compiled file when it exists and was compiled
+         * from the same style sheet class and StyleSheet::rulesVersion, skipping the selector
+         * parsing. Otherwise the style sheet is loaded as usual and compiled to the file for the
+         * next start. Fonts and skins are always loaded, they have to be loaded in
+         * StyleSheet::loadResources.
+         *
+         * @tparam T Style sheet class
+         * @param compiledPath Path of the compiled style sheet
+         * @param reset Clear the manager first
+         */
+        template<typename T>
+        void loadStyleSheet(const std::string &compiledPath, bool reset = false) {
+            static_assert(std::is_base_of<StyleSheet, T>::value, "T must extend StyleSheet");
+            if (reset) {
+                this->reset();
+            }
+            auto sheet = std::make_unique<T>();
+            sheet->loadResources(this);
+            const std::string   key   = typeid(T).name();
+            const std::uint32_t stamp = sheet->rulesVersion();
+            if (!CompiledStyleSheet::load(this, compiledPath, key, stamp)) {
+                // Declare the rules on their own so that only this style sheet is compiled
+                StyleManager authored{};
+                sheet->load(&authored);
+                const std::string compiled = CompiledStyleSheet::compile(&authored, key, stamp);
+                if (!CompiledStyleSheet::save(compiled, compiledPath)) {
+                    std::cerr << "Could not write compiled style sheet \"" << compiledPath << "\"" << std::endl;
+                }
+                CompiledStyleSheet::load(this, compiled.data(), compiled.size(), key, stamp);
+            }
             _valid = false;
         }
 
@@ -52,12 +118,164 @@ namespace psychic_ui {
         std::shared_ptr<internal::SkinBase> skin(const std::string &name);
 
         Style *style(std::string selector);
-        std::unique_ptr<Style> computeStyle(const Div *component);
+
+        /**
+         * Retire every declaration owned by a div
+         * Invalidates the manager so that the divs that matched them are restyled,
+         * the styles of the retired declarations must not be used anymore.
+         * @param owner
+         */
+        void release(const Div *owner);
+
+        /**
+         * Compute the style of a component
+         * Only reads the style manager, it can be called from several threads at once as long
+         * as no declaration, font or skin is added at the same time.
+         * @param component
+         * @param filter Ancestors of the component, used to quickly reject descendant selectors
+         * @param sibling Sibling restyled since the parent was, its inherited values are reused
+         * @return Computed style
+         */
+        std::unique_ptr<Style> computeStyle(
+            const Div *component,
+            const AncestorFilter *filter = nullptr,
+            const Div *sibling = nullptr
+        ) const;
+
+        /**
+         * Check if the computed style of a sibling can be reused as the computed style of a component
+         * They must match the same declarations, inherit from the same parent style and have the same
+         * inline and default styles, the sibling's computed style also has to be up to date.
+         * @param component
+         * @param sibling
+         * @return Whether computeStyle(component) would compute the same style as the sibling's
+         */
+        bool canShareStyle(const Div *component, const Div *sibling) const;
+
+        /**
+         * State of the pseudo classes of a component, one bit per Pseudo
+         * @param component
+         * @return Pseudo class flags
+         */
+        static unsigned int pseudoState(const Div *component);
+
+        /**
+         * What has to be restyled when a pseudo class of a component changes
+         * @param pseudo
+         * @return Invalidation required by the declarations
+         */
+        StyleInvalidation invalidation(Pseudo pseudo) const;
+
+        /**
+         * What has to be restyled when a class is added to or removed from a component
+         * @param className
+         * @return Invalidation required by the declarations
+         */
+        StyleInvalidation classInvalidation(const Atom &className) const;
+
+        /**
+         * What has to be restyled when a component gains or loses an id
+         * @param id
+         * @return Invalidation required by the declarations
+         */
+        StyleInvalidation idInvalidation(const Atom &id) const;
 
     protected:
+        /**
+         * Get the style of a declaration owned by a div, through Div::ownedStyle so that
+         * the owner knows which managers to release it from
+         * Owned declarations are retired when their owner is destroyed, they are meant for
+         * rules that only make sense for one instance, like rules targeting the owner's internal id.
+         * Selectors that were already declared stay with their current owner.
+         * @param selector
+         * @param owner
+         * @return Style of the declaration
+         */
+        Style *style(std::string selector, const Div *owner);
+
+        /**
+         * Add a declaration for a selector that is not declared yet
+         * @param selectorString Lowercase selector string
+         * @param selector Parsed selector
+         * @return Style of the declaration
+         */
+        Style *declare(std::string selectorString, std::unique_ptr<StyleSelector> selector);
+
+        using DeclarationBucket = std::vector<StyleDeclaration *>;
+        using DeclarationIndex = std::unordered_map<Atom, DeclarationBucket>;
+
         std::unordered_map<std::string, std::unique_ptr<StyleDeclaration>> _declarations{};
         std::unordered_map<std::string, sk_sp<SkTypeface>>                 _fonts{};
         std::unordered_map<std::string, SkinMaker>                         _skins{};
         bool                                                               _valid{false};
+
+        /**
+         * Selectors of the declarations owned by divs, by owner
+         */
+        std::unordered_map<const Div *, std::vector<std::string>> _ownedDeclarations{};
+
+        /**
+         * Number of declarations made, gives every declaration its order
+         */
+        std::size_t _declarationCount{0};
+
+        /**
+         * Declarations indexed by the rightmost compound of their selector
+         * A declaration goes in exactly one bucket, the first that applies of: its id,
+         * its first class, its tag or the universal bucket. Only the buckets matching
+         * a div's id, classes and tags can contain declarations matching that div.
+         * Selectors ending with the "*" tag are not indexed, the "*" declaration is
+         * applied as the base of every computed style instead. The indexes are only meant
+         * for matching, go through every declaration with declarationsInOrder().
+         */
+        DeclarationIndex  _idIndex{};
+        DeclarationIndex  _classIndex{};
+        DeclarationIndex  _tagIndex{};
+        DeclarationBucket _universalIndex{};
+
+        /**
+         * Pseudo classes used by the rightmost compound of the declarations, one bit per Pseudo
+         */
+        unsigned int _pseudoMask{0};
+
+        /**
+         * Invalidation sets, what the declarations' selectors reference
+         * The subject sets come from the rightmost compounds and only affect the div that changed,
+         * the ancestor sets come from the other compounds and affect the whole subtree.
+         * They count one entry per declaration so that retired declarations can be removed.
+         */
+        unsigned int                  _ancestorPseudoMask{0};
+        std::unordered_multiset<Atom> _subjectClasses{};
+        std::unordered_multiset<Atom> _ancestorClasses{};
+        std::unordered_multiset<Atom> _subjectIds{};
+        std::unordered_multiset<Atom> _ancestorIds{};
+
+        /**
+         * Every declaration, including the ones that are not indexed, in declaration order
+         * @return Declarations, first declared first
+         */
+        std::vector<const StyleDeclaration *> declarationsInOrder() const;
+
+        /**
+         * Add a new declaration to the index
+         * @param declaration
+         */
+        void indexDeclaration(StyleDeclaration *declaration);
+
+        /**
+         * Remove a declaration from the index
+         * @param declaration
+         */
+        void unindexDeclaration(StyleDeclaration *declaration);
+
+        /**
+         * Get the declarations matching a component
+         * Only the candidates found in the index are tested against the component
+         * @param component
+         * @param filter Ancestors of the component, when available
+         * @return Matching declarations, sorted by weight, heaviest last
+         */
+        std::vector<std::pair<int, StyleDeclaration *>>
+        matchingDeclarations(const Div *component, const AncestorFilter *filter = nullptr) const;
     };
 }
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include "StyleSelector.hpp"
+#include "AncestorFilter.hpp"
 #include "psychic-ui/Div.hpp"
 #include "../utils/StringUtils.hpp"
 
@@ -97,9 +98,29 @@ namespace psychic_ui {
             selector = std::move(r);
         }
 
+        if (selector) {
+            selector->computeAncestorKeys();
+        }
+
         return selector;
     }
 
+    void StyleSelector::computeAncestorKeys() {
+        // Keys the ancestors need to have for the selector to match
+        _ancestorKeys.clear();
+        for (const StyleSelector *ancestor = _next.get(); ancestor; ancestor = ancestor->_next.get()) {
+            if (!ancestor->_tag.empty()) {
+                _ancestorKeys.push_back(AncestorFilter::tagKey(ancestor->_tag));
+            }
+            if (!ancestor->_id.empty()) {
+                _ancestorKeys.push_back(AncestorFilter::idKey(ancestor->_id));
+            }
+            for (const auto &className : ancestor->_classes) {
+                _ancestorKeys.push_back(AncestorFilter::classKey(className));
+            }
+        }
+    }
+
     bool StyleSelector::matches(const Div *component) const {
         return matches(component, false);
     }
@@ -115,7 +136,7 @@ namespace psychic_ui {
         const Div *parent = component->parent();
 
         // Match id
-        if ((!_id.empty() && component->id() != _id) && (component->internalId() != _id)) {
+        if (!_id.empty() && component->idAtom() != _id && component->internalIdAtom() != _id) {
             return parentMatches;
         }
 
@@ -128,12 +149,8 @@ namespace psychic_ui {
         if (!std::all_of(
             _classes.cbegin(),
             _classes.cend(),
-            [&component](const auto &className) {
-                return std::find(
-                    component->classNames().cbegin(),
-                    component->classNames().cend(),
-                    className
-                ) != component->classNames().cend();
+            [&component](const Atom &className) {
+                return component->hasClassName(className);
             }
         )) {
             return parentMatches;
@@ -186,15 +203,15 @@ namespace psychic_ui {
         return _depth;
     }
 
-    const std::string StyleSelector::tag() const {
+    const Atom &StyleSelector::tag() const {
         return _tag;
     }
 
-    const std::string StyleSelector::id() const {
+    const Atom &StyleSelector::id() const {
         return _id;
     }
 
-    const std::vector<std::string> StyleSelector::classes() const {
+    const std::vector<Atom> &StyleSelector::classes() const {
         return _classes;
     }
 
@@ -206,6 +223,10 @@ namespace psychic_ui {
         return _next.get();
     }
 
+    const std::vector<unsigned int> &StyleSelector::ancestorKeys() const {
+        return _ancestorKeys;
+    }
+
     int StyleSelector::weight() const {
         int w = _id.empty() ? 0 : 15; // ??? Is 15 too much?
         w += _tag.empty() ? 0 : 10;
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include <unordered_set>
+#include "../utils/Atom.hpp"
 
 namespace psychic_ui {
     class Div;
@@ -26,6 +27,8 @@ namespace psychic_ui {
     };
 
     class StyleSelector {
+        friend class CompiledStyleSheet;
+
     public:
         static std::unique_ptr<StyleSelector> fromSelector(const std::string &selector);
 
@@ -33,12 +36,18 @@ namespace psychic_ui {
 
         bool direct() const;
         int depth() const;
-        const std::string tag() const;
-        const std::string id() const;
-        const std::vector<std::string> classes() const;
+        const Atom &tag() const;
+        const Atom &id() const;
+        const std::vector<Atom> &classes() const;
         const std::unordered_set<Pseudo, std::hash<int>> pseudo() const;
         const StyleSelector *next() const;
 
+        /**
+         * AncestorFilter keys of every tag, id and class required from the ancestors
+         * If one of them is missing from the ancestors the selector cannot match
+         */
+        const std::vector<unsigned int> &ancestorKeys() const;
+
         /**
          * Computes the selector's weight
          * This is used when trying to figure out selectors priority
@@ -59,12 +68,19 @@ namespace psychic_ui {
          * @return
          */
         bool matches(const Div *component, bool expand) const;
+
+        /**
+         * Collect the ancestor keys of the chain, once it is complete
+         */
+        void computeAncestorKeys();
+
         bool                                       _direct{false};
         int                                        _depth{0};
-        std::string                                _tag{};
-        std::string                                _id{};
-        std::vector<std::string>                   _classes{};
+        Atom                                       _tag{};
+        Atom                                       _id{};
+        std::vector<Atom>                          _classes{};
         std::unordered_set<Pseudo, std::hash<int>> _pseudo{};
         std::unique_ptr<StyleSelector>             _next{nullptr};
+        std::vector<unsigned int>                  _ancestorKeys{};
     };
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include "../utils/Hatcher.hpp"
 
 namespace psychic_ui {
@@ -10,7 +11,26 @@ namespace psychic_ui {
 
     class StyleSheet {
     public:
+        /**
+         * Load the fonts and skins of the style sheet
+         * They are code and files, not declarations, so they are loaded even when the
+         * declarations come from a compiled style sheet. See StyleManager::loadStyleSheet.
+         * @param manager
+         */
+        virtual void loadResources(StyleManager *manager) {}
+
+        /**
+         * Declare the rules of the style sheet
+         * @param manager
+         */
         virtual void load(StyleManager *manager) = 0;
+
+        /**
+         * Version of the rules declared by load()
+         * It is stored in compiled style sheets, a compiled style sheet of another version
+         * is compiled again. Return a new value whenever the rules change.
+         * @return Version of the rules
+         */
+        virtual std::uint32_t rulesVersion() const { return 0; }
     };
 }
-
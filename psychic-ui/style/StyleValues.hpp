@@ -0,0 +1,315 @@
+#pragma once
+
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../utils/StringPool.hpp"
+
+namespace psychic_ui {
+
+    /**
+     * How a style value type is stored in StyleValues
+     * Most values are stored as-is, strings are interned so that a value is a single pointer
+     * and comparing two values is a pointer comparison.
+     */
+    template<typename T>
+    struct StyleStorage {
+        using Stored = T;
+
+        static const T &store(const T &value) {
+            return value;
+        }
+
+        static const T &load(const T &value) {
+            return value;
+        }
+    };
+
+    template<>
+    struct StyleStorage<std::string> {
+        using Stored = const std::string *;
+
+        static Stored store(const std::string &value) {
+            return StringPool::intern(value);
+        }
+
+        static const std::string &load(Stored value) {
+            return *value;
+        }
+    };
+
+    template<>
+    struct StyleStorage<bool> {
+        // Avoids the std::vector<bool> specialization, values have to be addressable
+        using Stored = std::uint8_t;
+
+        static Stored store(const bool value) {
+            return static_cast<Stored>(value);
+        }
+
+        static bool load(const Stored value) {
+            return value != 0;
+        }
+    };
+
+    /**
+     * Equality of two stored values
+     * NaN floats are equal so that `Style::Auto` values compare the same between two styles
+     */
+    template<typename T>
+    inline bool styleValueEquals(const T &a, const T &b) {
+        return a == b;
+    }
+
+    template<>
+    inline bool styleValueEquals<float>(const float &a, const float &b) {
+        return a == b || (std::isnan(a) && std::isnan(b));
+    }
+
+    /**
+     * Dense storage for the values of one property enum
+     *
+     * A bitset tells which of the N properties are present and the values of the present
+     * properties are packed in enum order, so an empty set of values only costs the bitset
+     * and an empty vector. Finding a value is a popcount, overlaying another set of values
+     * is a single ordered merge instead of a hash lookup per property.
+     *
+     * @tparam T Stored value type
+     * @tparam N Number of properties in the enum
+     */
+    template<typename T, std::size_t N>
+    class StyleValues {
+    public:
+        using Mask = std::bitset<N>;
+
+        bool has(const std::size_t property) const {
+            return _present.test(property);
+        }
+
+        /**
+         * Find the value of a property
+         * @param property
+         * @return Pointer to the value, nullptr when the property is not set
+         */
+        const T *find(const std::size_t property) const {
+            return _present.test(property) ? &_values[rank(property)] : nullptr;
+        }
+
+        /**
+         * Set the value of a property
+         * @param property
+         * @param value
+         * @return Whether the value changed
+         */
+        bool set(const std::size_t property, const T &value) {
+            const std::size_t position = rank(property);
+            if (_present.test(property)) {
+                if (styleValueEquals(_values[position], value)) {
+                    return false;
+                }
+                _values[position] = value;
+            } else {
+                _present.set(property);
+                _values.insert(_values.begin() + position, value);
+            }
+            return true;
+        }
+
+        /**
+         * Set every property present in from onto this
+         */
+        void overlay(const StyleValues &from) {
+            merge(from, from._present);
+        }
+
+        /**
+         * Set every property present in from and in mask onto this
+         */
+        void overlay(const StyleValues &from, const Mask &mask) {
+            merge(from, from._present & mask);
+        }
+
+        /**
+         * Set every property present in from but missing in this
+         */
+        void defaults(const StyleValues &from) {
+            merge(from, from._present & ~_present);
+        }
+
+        /**
+         * Remove every property present in mask
+         */
+        void remove(const Mask &mask) {
+            const Mask removed = _present & mask;
+            if (removed.none()) {
+                return;
+            }
+
+            std::size_t kept     = 0;
+            std::size_t position = 0;
+            for (std::size_t property = 0; property < N; ++property) {
+                if (_present.test(property)) {
+                    if (!removed.test(property)) {
+                        _values[kept++] = std::move(_values[position]);
+                    }
+                    ++position;
+                }
+            }
+            _values.erase(_values.begin() + kept, _values.end());
+            _present &= ~removed;
+        }
+
+        const Mask &mask() const {
+            return _present;
+        }
+
+        std::size_t size() const {
+            return _values.size();
+        }
+
+        bool empty() const {
+            return _values.empty();
+        }
+
+        /**
+         * Call callback(property, value) for every present property, in enum order
+         */
+        template<typename Callback>
+        void forEach(Callback callback) const {
+            std::size_t position = 0;
+            for (std::size_t property = 0; property < N && position < _values.size(); ++property) {
+                if (_present.test(property)) {
+                    callback(property, _values[position++]);
+                }
+            }
+        }
+
+        /**
+         * Properties that are set in only one of this and other or that have different values
+         */
+        Mask difference(const StyleValues &other) const {
+            Mask        changed = _present ^ other._present;
+            const Mask  common  = _present & other._present;
+            if (common.none()) {
+                return changed;
+            }
+            std::size_t mine    = 0;
+            std::size_t theirs  = 0;
+            for (std::size_t property = 0; property < N; ++property) {
+                const bool inMine   = _present.test(property);
+                const bool inTheirs = other._present.test(property);
+                if (common.test(property) && !styleValueEquals(_values[mine], other._values[theirs])) {
+                    changed.set(property);
+                }
+                mine += inMine;
+                theirs += inTheirs;
+            }
+            return changed;
+        }
+
+        /**
+         * Same as difference(other) when each side falls back to another set of values
+         * (ex: inherited values) for the properties it doesn't set
+         * @param other
+         * @param fallback Fallback of this, can be nullptr
+         * @param otherFallback Fallback of other, can be nullptr
+         */
+        Mask difference(const StyleValues &other, const StyleValues *fallback, const StyleValues *otherFallback) const {
+            if (!fallback && !otherFallback) {
+                return difference(other);
+            }
+
+            const Mask mine    = fallback ? _present | fallback->_present : _present;
+            const Mask theirs  = otherFallback ? other._present | otherFallback->_present : other._present;
+            Mask       changed = mine ^ theirs;
+            const Mask common  = mine & theirs;
+            for (std::size_t property = 0; property < N; ++property) {
+                if (!common.test(property)) {
+                    continue;
+                }
+                const T *value      = _present.test(property) ? find(property) : fallback->find(property);
+                const T *otherValue = other._present.test(property) ? other.find(property) : otherFallback->find(property);
+                // Both sides often fall back to the same shared values
+                if (value != otherValue && !styleValueEquals(*value, *otherValue)) {
+                    changed.set(property);
+                }
+            }
+            return changed;
+        }
+
+        bool operator==(const StyleValues &other) const {
+            if (_present != other._present) {
+                return false;
+            }
+            for (std::size_t i = 0; i < _values.size(); ++i) {
+                if (!styleValueEquals(_values[i], other._values[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const StyleValues &other) const {
+            return !(*this == other);
+        }
+
+    protected:
+        Mask           _present{};
+        std::vector<T> _values{};
+
+        /**
+         * Position of a property in the packed values, the number of present properties before it
+         */
+        std::size_t rank(const std::size_t property) const {
+            return property == 0 ? 0 : (_present << (N - property)).count();
+        }
+
+        /**
+         * Copy the properties of `from` listed in `mask` (a subset of from's properties) onto this
+         */
+        void merge(const StyleValues &from, const Mask &mask) {
+            if (mask.none()) {
+                return;
+            }
+
+            if ((mask & ~_present).none()) {
+                // Only replacing existing values, the layout does not change
+                std::size_t mine   = 0;
+                std::size_t theirs = 0;
+                for (std::size_t property = 0; property < N; ++property) {
+                    const bool inMine   = _present.test(property);
+                    const bool inTheirs = from._present.test(property);
+                    if (mask.test(property)) {
+                        _values[mine] = from._values[theirs];
+                    }
+                    mine += inMine;
+                    theirs += inTheirs;
+                }
+                return;
+            }
+
+            const Mask     merged = _present | mask;
+            std::vector<T> values;
+            values.reserve(merged.count());
+            std::size_t mine   = 0;
+            std::size_t theirs = 0;
+            for (std::size_t property = 0; property < N; ++property) {
+                const bool inMine   = _present.test(property);
+                const bool inTheirs = from._present.test(property);
+                if (mask.test(property)) {
+                    values.push_back(from._values[theirs]);
+                } else if (inMine) {
+                    values.push_back(std::move(_values[mine]));
+                }
+                mine += inMine;
+                theirs += inTheirs;
+            }
+            _present = merged;
+            _values  = std::move(values);
+        }
+    };
+}
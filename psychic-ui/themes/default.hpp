@@ -75,16 +75,7 @@ protected:
 public:
     PsychicUIStyleSheet() = default;
 
-    void load(StyleManager *manager) override {
-        int smallText     = 10;
-        int text          = 12;
-        int mediumText    = 14;
-        int largeText     = 18;
-        int bigText       = 24;
-        int hugeText      = 36;
-        int radius        = 7;
-        int scrollBarSize = 12;
-
+    void loadResources(StyleManager *manager) override {
         manager->loadFont("Ubuntu Light", "../res/fonts/Ubuntu/Ubuntu-Light.ttf");
         manager->loadFont("Ubuntu Regular", "../res/fonts/Ubuntu/Ubuntu-Regular.ttf");
 
@@ -98,6 +89,17 @@ public:
         manager->registerSkin("sub-menu-button-skin", SkinType::make([]() { return std::make_shared<DefaultSubMenuButtonSkin>(); }));
         manager->registerSkin("title-bar-button", SkinType::make([]() { return std::make_shared<TitleBarButtonSkin>(); }));
         manager->registerSkin("slider", SkinType::make([]() { return std::make_shared<SliderRangeSkin>(); }));
+    }
+
+    void load(StyleManager *manager) override {
+        int smallText     = 10;
+        int text          = 12;
+        int mediumText    = 14;
+        int largeText     = 18;
+        int bigText       = 24;
+        int hugeText      = 36;
+        int radius        = 7;
+        int scrollBarSize = 12;
 
         // region Defaults
         manager->style("*")
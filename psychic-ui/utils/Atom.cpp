@@ -0,0 +1,45 @@
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Atom.hpp"
+
+namespace psychic_ui {
+
+    namespace {
+        struct AtomTable {
+            std::mutex                                    mutex{};
+            std::unordered_map<std::string, unsigned int> ids{{"", 0}};
+            // Points to the keys of ids, nodes of an unordered_map never move
+            std::vector<const std::string *>              strings{&ids.begin()->first};
+        };
+
+        // Lazily constructed, atoms can be created during static initialization
+        AtomTable &table() {
+            static AtomTable atomTable{};
+            return atomTable;
+        }
+    }
+
+    Atom::Atom(const std::string &value) {
+        if (value.empty()) {
+            return;
+        }
+
+        AtomTable                   &atoms = table();
+        std::lock_guard<std::mutex> lock(atoms.mutex);
+        auto                        res    = atoms.ids.emplace(value, static_cast<unsigned int>(atoms.strings.size()));
+        if (res.second) {
+            atoms.strings.push_back(&res.first->first);
+        }
+        _id = res.first->second;
+    }
+
+    Atom::Atom(const char *value) :
+        Atom(std::string(value)) {}
+
+    const std::string &Atom::str() const {
+        AtomTable                   &atoms = table();
+        std::lock_guard<std::mutex> lock(atoms.mutex);
+        return *atoms.strings[_id];
+    }
+}
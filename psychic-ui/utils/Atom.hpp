@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace psychic_ui {
+
+    /**
+     * Handle to a string interned in the process wide atom table
+     *
+     * Equal strings always get the same small integer handle, so atoms are compared, hashed
+     * and sorted as integers. Used for tags, ids and class names that are compared on every
+     * selector match. The empty string is atom 0. Atoms are never released, don't make atoms
+     * out of unbounded content.
+     */
+    class Atom {
+    public:
+        Atom() = default;
+        Atom(const std::string &value);
+        Atom(const char *value);
+
+        /**
+         * Interned string of this atom
+         * Safe to call from any thread, but it takes a lock, keep it out of hot paths
+         */
+        const std::string &str() const;
+
+        unsigned int id() const {
+            return _id;
+        }
+
+        bool empty() const {
+            return _id == 0;
+        }
+
+        friend bool operator==(const Atom &a, const Atom &b) {
+            return a._id == b._id;
+        }
+
+        friend bool operator!=(const Atom &a, const Atom &b) {
+            return a._id != b._id;
+        }
+
+        /**
+         * Order of creation, not alphabetical
+         */
+        friend bool operator<(const Atom &a, const Atom &b) {
+            return a._id < b._id;
+        }
+
+        friend std::ostream &operator<<(std::ostream &stream, const Atom &atom) {
+            return stream << atom.str();
+        }
+
+    protected:
+        unsigned int _id{0};
+    };
+}
+
+namespace std {
+    template<>
+    struct hash<psychic_ui::Atom> {
+        std::size_t operator()(const psychic_ui::Atom &atom) const {
+            return atom.id();
+        }
+    };
+}
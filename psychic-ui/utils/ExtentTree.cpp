@@ -0,0 +1,80 @@
+#include "ExtentTree.hpp"
+
+namespace psychic_ui {
+
+    void ExtentTree::reset(const std::size_t count, const int extent) {
+        _extents.assign(count, extent);
+
+        // Linear build, every node adds itself to its parent
+        _tree.assign(count + 1, 0);
+        for (std::size_t i = 1; i <= count; ++i) {
+            _tree[i] += extent;
+            const std::size_t parent = i + (i & (~i + 1));
+            if (parent <= count) {
+                _tree[parent] += _tree[i];
+            }
+        }
+
+        _searchMask = 0;
+        if (count > 0) {
+            _searchMask = 1;
+            while (_searchMask <= count / 2) {
+                _searchMask <<= 1;
+            }
+        }
+    }
+
+    std::size_t ExtentTree::size() const {
+        return _extents.size();
+    }
+
+    bool ExtentTree::empty() const {
+        return _extents.empty();
+    }
+
+    int ExtentTree::extent(const std::size_t index) const {
+        return _extents[index];
+    }
+
+    bool ExtentTree::setExtent(const std::size_t index, const int extent) {
+        const int delta = extent - _extents[index];
+        if (delta == 0) {
+            return false;
+        }
+        _extents[index] = extent;
+        for (std::size_t i = index + 1; i < _tree.size(); i += i & (~i + 1)) {
+            _tree[i] += delta;
+        }
+        return true;
+    }
+
+    int ExtentTree::offset(const std::size_t index) const {
+        int sum = 0;
+        for (std::size_t i = index < _extents.size() ? index : _extents.size(); i > 0; i -= i & (~i + 1)) {
+            sum += _tree[i];
+        }
+        return sum;
+    }
+
+    int ExtentTree::total() const {
+        return offset(_extents.size());
+    }
+
+    std::size_t ExtentTree::indexAt(const int offset) const {
+        if (offset < 0) {
+            return 0;
+        }
+
+        // Walk down the tree, skipping whole nodes that end at or before the offset
+        std::size_t position  = 0;
+        int         remaining = offset;
+        for (std::size_t step = _searchMask; step > 0; step >>= 1) {
+            const std::size_t next = position + step;
+            if (next < _tree.size() && _tree[next] <= remaining) {
+                position = next;
+                remaining -= _tree[next];
+            }
+        }
+        return position;
+    }
+}
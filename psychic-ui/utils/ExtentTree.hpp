@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace psychic_ui {
+
+    /**
+     * Extents of a sequence of items (ex: the heights of the rows of a list)
+     *
+     * Stored as a Fenwick tree so that changing the extent of one item, finding the offset of
+     * an item and finding the item at an offset are all O(log n), which keeps virtualized
+     * lists of millions of items with measured extents cheap to scroll.
+     */
+    class ExtentTree {
+    public:
+        ExtentTree() = default;
+
+        /**
+         * Replace every item
+         * @param count Number of items
+         * @param extent Extent of every item
+         */
+        void reset(std::size_t count, int extent);
+
+        std::size_t size() const;
+
+        bool empty() const;
+
+        int extent(std::size_t index) const;
+
+        /**
+         * Change the extent of one item
+         * @param index
+         * @param extent
+         * @return Whether the extent changed
+         */
+        bool setExtent(std::size_t index, int extent);
+
+        /**
+         * Offset of an item, the sum of the extents of the items before it
+         * @param index Item index, size() gives the total extent
+         */
+        int offset(std::size_t index) const;
+
+        /**
+         * Sum of all the extents
+         */
+        int total() const;
+
+        /**
+         * Find the item at an offset
+         * @param offset
+         * @return Index of the item spanning that offset, 0 for negative offsets
+         *         and size() for offsets past the last item
+         */
+        std::size_t indexAt(int offset) const;
+
+    protected:
+        std::vector<int> _extents{};
+
+        /**
+         * 1-based Fenwick tree of the extents
+         */
+        std::vector<int> _tree{};
+
+        /**
+         * Largest power of two not greater than the item count, where searches start
+         */
+        std::size_t _searchMask{0};
+    };
+}
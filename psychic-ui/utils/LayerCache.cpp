@@ -0,0 +1,102 @@
+#include "LayerCache.hpp"
+
+namespace psychic_ui {
+
+    std::shared_ptr<LayerCache> LayerCache::instance{nullptr};
+
+    const std::size_t LayerCache::defaultBudget = 64 * 1024 * 1024;
+
+    std::shared_ptr<LayerCache> LayerCache::getInstance() {
+        static std::once_flag once{};
+        std::call_once(once, []() { instance = std::make_shared<LayerCache>(); });
+        return instance;
+    }
+
+    LayerCache::LayerCache(const std::size_t budget) :
+        _budget(budget) {}
+
+    std::size_t LayerCache::bytesOf(const SkImage *image) {
+        // Layers are N32 rasters
+        return image ? static_cast<std::size_t>(image->width()) * static_cast<std::size_t>(image->height()) * 4 : 0;
+    }
+
+    sk_sp<SkImage> LayerCache::find(const void *owner) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto                        it = _index.find(owner);
+        if (it == _index.end()) {
+            return nullptr;
+        }
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return it->second->image;
+    }
+
+    bool LayerCache::insert(const void *owner, sk_sp<SkImage> image) {
+        const std::size_t bytes = bytesOf(image.get());
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto                        it = _index.find(owner);
+        if (it != _index.end()) {
+            _bytes -= it->second->bytes;
+            _entries.erase(it->second);
+            _index.erase(it);
+        }
+
+        if (!image || bytes > _budget) {
+            return false;
+        }
+
+        _entries.push_front(Entry{owner, std::move(image), bytes});
+        _index[owner] = _entries.begin();
+        _bytes += bytes;
+        evict();
+        return true;
+    }
+
+    void LayerCache::remove(const void *owner) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto                        it = _index.find(owner);
+        if (it == _index.end()) {
+            return;
+        }
+        _bytes -= it->second->bytes;
+        _entries.erase(it->second);
+        _index.erase(it);
+    }
+
+    void LayerCache::clear() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.clear();
+        _index.clear();
+        _bytes = 0;
+    }
+
+    std::size_t LayerCache::budget() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _budget;
+    }
+
+    void LayerCache::setBudget(const std::size_t budget) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _budget = budget;
+        evict();
+    }
+
+    std::size_t LayerCache::bytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _bytes;
+    }
+
+    std::size_t LayerCache::count() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _entries.size();
+    }
+
+    void LayerCache::evict() {
+        while (_bytes > _budget && !_entries.empty()) {
+            const Entry &oldest = _entries.back();
+            _bytes -= oldest.bytes;
+            _index.erase(oldest.owner);
+            _entries.pop_back();
+        }
+    }
+}
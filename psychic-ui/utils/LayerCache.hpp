@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <SkImage.h>
+
+namespace psychic_ui {
+
+    /**
+     * Process wide cache of rasterized layers
+     *
+     * Layers are keyed by their owner (ex: a div with the `layer` style property) and share a
+     * single memory budget across every window. Once the budget is exceeded, the least
+     * recently composited layers are evicted and their owners rasterize them again the next
+     * time they are rendered.
+     */
+    class LayerCache {
+    public:
+        /**
+         * Shared cache
+         */
+        static std::shared_ptr<LayerCache> getInstance();
+
+        /**
+         * 64MB, a few full screen layers
+         */
+        static const std::size_t defaultBudget;
+
+        /**
+         * @param budget Maximum number of bytes of pixels kept in the cache
+         */
+        explicit LayerCache(std::size_t budget = defaultBudget);
+
+        LayerCache(const LayerCache &) = delete;
+        LayerCache &operator=(const LayerCache &) = delete;
+
+        /**
+         * Find the layer of an owner, marking it as the most recently used
+         * @param owner
+         * @return Layer image, nullptr when the owner has none or when it was evicted
+         */
+        sk_sp<SkImage> find(const void *owner);
+
+        /**
+         * Store the layer of an owner, replacing its previous layer,
+         * then evict the least recently used layers until the cache fits its budget
+         * @param owner
+         * @param image
+         * @return Whether the layer is cached, false when it is larger than the whole budget
+         */
+        bool insert(const void *owner, sk_sp<SkImage> image);
+
+        /**
+         * Drop the layer of an owner, if any
+         * @param owner
+         */
+        void remove(const void *owner);
+
+        /**
+         * Drop every layer
+         */
+        void clear();
+
+        std::size_t budget() const;
+
+        /**
+         * Change the budget, evicting layers if the cache no longer fits
+         * @param budget
+         */
+        void setBudget(std::size_t budget);
+
+        /**
+         * Bytes of pixels currently cached
+         */
+        std::size_t bytes() const;
+
+        /**
+         * Number of cached layers
+         */
+        std::size_t count() const;
+
+        /**
+         * Bytes of pixels of an image
+         */
+        static std::size_t bytesOf(const SkImage *image);
+
+    protected:
+        static std::shared_ptr<LayerCache> instance;
+
+        struct Entry {
+            const void     *owner;
+            sk_sp<SkImage> image;
+            std::size_t    bytes;
+        };
+
+        /**
+         * Most recently used first
+         */
+        std::list<Entry>                                             _entries{};
+        std::unordered_map<const void *, std::list<Entry>::iterator> _index{};
+        std::size_t                                                  _budget;
+        std::size_t                                                  _bytes{0};
+
+        /**
+         * Windows can render from different threads
+         */
+        mutable std::mutex _mutex{};
+
+        /**
+         * Evict the least recently used layers until the cache fits its budget
+         * Must be called with the mutex held
+         */
+        void evict();
+    };
+}
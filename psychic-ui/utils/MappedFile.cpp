@@ -0,0 +1,75 @@
+#include "MappedFile.hpp"
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace psychic_ui {
+
+    #if defined(_WIN32)
+
+    MappedFile::MappedFile(const std::string &path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            return;
+        }
+        const std::streamoff size = file.tellg();
+        if (size <= 0) {
+            return;
+        }
+        _buffer.resize(static_cast<std::size_t>(size));
+        file.seekg(0);
+        if (!file.read(_buffer.data(), size)) {
+            _buffer.clear();
+            return;
+        }
+        _data = _buffer.data();
+        _size = _buffer.size();
+    }
+
+    MappedFile::~MappedFile() = default;
+
+    #else
+
+    MappedFile::MappedFile(const std::string &path) {
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) {
+            return;
+        }
+        struct stat info{};
+        if (::fstat(file, &info) == 0 && info.st_size > 0) {
+            void *data = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED) {
+                _data = static_cast<const char *>(data);
+                _size = static_cast<std::size_t>(info.st_size);
+            }
+        }
+        // The mapping stays valid once the file is closed
+        ::close(file);
+    }
+
+    MappedFile::~MappedFile() {
+        if (_data) {
+            ::munmap(const_cast<char *>(_data), _size);
+        }
+    }
+
+    #endif
+
+    bool MappedFile::valid() const {
+        return _data != nullptr;
+    }
+
+    const char *MappedFile::data() const {
+        return _data;
+    }
+
+    std::size_t MappedFile::size() const {
+        return _size;
+    }
+}
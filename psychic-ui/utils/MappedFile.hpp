@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace psychic_ui {
+
+    /**
+     * Read only view of a whole file
+     *
+     * The file is memory mapped where the platform allows it, so opening it costs no copy
+     * and only the pages actually read are loaded. Elsewhere it is read into a buffer.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /**
+         * Whether the file could be opened, an empty file is not valid
+         */
+        bool valid() const;
+
+        const char *data() const;
+        std::size_t size() const;
+
+    protected:
+        const char  *_data{nullptr};
+        std::size_t _size{0};
+
+        #if defined(_WIN32)
+        std::vector<char> _buffer{};
+        #endif
+    };
+}
@@ -0,0 +1,87 @@
+#include "ObjectPool.hpp"
+#include <array>
+
+namespace psychic_ui {
+
+    const std::size_t ObjectPool::granularity;
+    const std::size_t ObjectPool::maxBlockSize;
+    const std::size_t ObjectPool::chunkSize;
+
+    namespace {
+        const std::size_t sizeClassCount = ObjectPool::maxBlockSize / ObjectPool::granularity;
+
+        std::size_t sizeClassIndex(const std::size_t size) {
+            return size == 0 ? 0 : (size - 1) / ObjectPool::granularity;
+        }
+    }
+
+    ObjectPool::SizeClass &ObjectPool::sizeClass(const std::size_t index) {
+        // Never destroyed, pooled objects can outlive static destruction
+        static auto *sizeClasses = new std::array<SizeClass, sizeClassCount>();
+        return (*sizeClasses)[index];
+    }
+
+    void *ObjectPool::allocate(const std::size_t size) {
+        if (size > maxBlockSize) {
+            return ::operator new(size);
+        }
+
+        const std::size_t index = sizeClassIndex(size);
+        SizeClass         &pool = sizeClass(index);
+
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        if (!pool.free) {
+            grow(pool, (index + 1) * granularity);
+        }
+        FreeBlock *block = pool.free;
+        pool.free = block->next;
+        --pool.freeCount;
+        ++pool.used;
+        return block;
+    }
+
+    void ObjectPool::deallocate(void *block, const std::size_t size) {
+        if (!block) {
+            return;
+        }
+
+        if (size > maxBlockSize) {
+            ::operator delete(block);
+            return;
+        }
+
+        SizeClass &pool = sizeClass(sizeClassIndex(size));
+
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        auto                        freeBlock = static_cast<FreeBlock *>(block);
+        freeBlock->next = pool.free;
+        pool.free = freeBlock;
+        ++pool.freeCount;
+        --pool.used;
+    }
+
+    void ObjectPool::grow(SizeClass &sizeClass, const std::size_t blockSize) {
+        const std::size_t count = chunkSize > blockSize ? chunkSize / blockSize : 1;
+        auto              chunk = static_cast<char *>(::operator new(count * blockSize));
+        // Thread the free list in address order
+        for (std::size_t i = count; i > 0; --i) {
+            auto block = reinterpret_cast<FreeBlock *>(chunk + (i - 1) * blockSize);
+            block->next = sizeClass.free;
+            sizeClass.free = block;
+        }
+        sizeClass.freeCount += count;
+        ++sizeClass.chunks;
+    }
+
+    ObjectPool::Stats ObjectPool::stats() {
+        Stats stats{};
+        for (std::size_t i = 0; i < sizeClassCount; ++i) {
+            SizeClass                   &pool = sizeClass(i);
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            stats.used += pool.used;
+            stats.free += pool.freeCount;
+            stats.chunks += pool.chunks;
+        }
+        return stats;
+    }
+}
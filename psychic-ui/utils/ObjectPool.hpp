@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace psychic_ui {
+
+    /**
+     * Pools of fixed size memory blocks for the objects that are created and destroyed in bulk
+     * (divs, styles, ...) when building and tearing down subtrees
+     *
+     * Blocks are grouped in size classes of `granularity` bytes up to `maxBlockSize`, every size
+     * class carves its blocks out of large chunks and keeps the freed blocks in a free list, so
+     * once a pool has grown to the size of the largest subtree, building that subtree again
+     * doesn't go through the general purpose allocator. Chunks are kept for the life of the
+     * process. Larger allocations are forwarded to the global operator new.
+     */
+    class ObjectPool {
+    public:
+        static const std::size_t granularity  = 16;
+        static const std::size_t maxBlockSize = 4096;
+
+        /**
+         * Bytes of blocks carved out of a chunk, at least one block
+         */
+        static const std::size_t chunkSize = 64 * 1024;
+
+        /**
+         * Allocate a block of at least `size` bytes
+         * @param size
+         * @return Memory suitably aligned for any fundamental type
+         */
+        static void *allocate(std::size_t size);
+
+        /**
+         * Give back a block obtained from allocate
+         * @param block
+         * @param size Size given to allocate
+         */
+        static void deallocate(void *block, std::size_t size);
+
+        struct Stats {
+            /**
+             * Blocks handed out and not given back yet
+             */
+            std::size_t used{0};
+            /**
+             * Blocks waiting in the free lists
+             */
+            std::size_t free{0};
+            /**
+             * Chunks obtained from the global allocator
+             */
+            std::size_t chunks{0};
+        };
+
+        static Stats stats();
+
+    protected:
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+
+        struct SizeClass {
+            std::mutex  mutex{};
+            FreeBlock   *free{nullptr};
+            std::size_t used{0};
+            std::size_t freeCount{0};
+            std::size_t chunks{0};
+        };
+
+        static SizeClass &sizeClass(std::size_t index);
+
+        /**
+         * Refill the free list of a size class with a new chunk
+         * Must be called with the size class mutex held
+         */
+        static void grow(SizeClass &sizeClass, std::size_t blockSize);
+    };
+
+    /**
+     * Standard allocator over ObjectPool, for std::allocate_shared and containers
+     * @tparam T
+     */
+    template<class T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        PoolAllocator() noexcept = default;
+
+        template<class U>
+        PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+        T *allocate(std::size_t n) {
+            return static_cast<T *>(ObjectPool::allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T *p, std::size_t n) noexcept {
+            ObjectPool::deallocate(p, n * sizeof(T));
+        }
+    };
+
+    template<class T, class U>
+    bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) noexcept {
+        return true;
+    }
+
+    template<class T, class U>
+    bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &) noexcept {
+        return false;
+    }
+
+    /**
+     * make_shared for pooled objects, the object and its control block share one pooled block
+     */
+    template<class T, class... Args>
+    std::shared_ptr<T> makePooled(Args &&... args) {
+        return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+    }
+}
@@ -0,0 +1,20 @@
+#include "StringPool.hpp"
+
+namespace psychic_ui {
+
+    std::mutex &StringPool::mutex() {
+        static std::mutex poolMutex{};
+        return poolMutex;
+    }
+
+    std::unordered_set<std::string> &StringPool::strings() {
+        static std::unordered_set<std::string> poolStrings{};
+        return poolStrings;
+    }
+
+    const std::string *StringPool::intern(const std::string &value) {
+        std::lock_guard<std::mutex> lock(mutex());
+        // Nodes of an unordered_set never move, pointers survive rehashing
+        return &*strings().insert(value).first;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace psychic_ui {
+
+    /**
+     * Process wide pool of immutable strings
+     *
+     * Interning a string returns a pointer that stays valid for the lifetime of the program and
+     * that is the same for every equal string, so interned strings can be stored as a single
+     * pointer and compared by address. Interned strings are never released, only use it
+     * for small vocabularies like style values, not for user content.
+     */
+    class StringPool {
+    public:
+        /**
+         * Get the unique instance of a string
+         * Safe to call from any thread
+         * @param value
+         * @return Pointer to the pooled copy of value
+         */
+        static const std::string *intern(const std::string &value);
+
+    protected:
+        /**
+         * Lazily constructed pool, strings can be interned during static initialization
+         */
+        static std::mutex &mutex();
+        static std::unordered_set<std::string> &strings();
+    };
+}
@@ -0,0 +1,181 @@
+#include "TaskPool.hpp"
+
+namespace psychic_ui {
+
+    namespace {
+        /**
+         * Queue of the worker running on this thread, -1 on threads outside of any pool
+         */
+        thread_local int        workerIndex = -1;
+        thread_local const void *workerPool = nullptr;
+    }
+
+    // region Pool
+
+    std::shared_ptr<TaskPool> TaskPool::instance{nullptr};
+
+    std::shared_ptr<TaskPool> TaskPool::getInstance() {
+        static std::once_flag once{};
+        std::call_once(once, []() { instance = std::make_shared<TaskPool>(); });
+        return instance;
+    }
+
+    unsigned int TaskPool::defaultThreadCount() {
+        const unsigned int hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 1;
+    }
+
+    TaskPool::TaskPool(const unsigned int threadCount) {
+        // One queue per worker plus one for the threads outside of the pool
+        for (unsigned int i = 0; i <= threadCount; ++i) {
+            _queues.push_back(std::make_unique<Queue>());
+        }
+        for (unsigned int i = 0; i < threadCount; ++i) {
+            _threads.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+    TaskPool::~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _stopping = true;
+        }
+        _wakeUp.notify_all();
+        for (auto &thread: _threads) {
+            thread.join();
+        }
+    }
+
+    unsigned int TaskPool::threadCount() const {
+        return static_cast<unsigned int>(_threads.size());
+    }
+
+    void TaskPool::push(Task task) {
+        // Workers queue on their own queue, the other threads share the last one
+        const auto index = workerPool == this ? static_cast<std::size_t>(workerIndex) : _queues.size() - 1;
+        {
+            // Counted before being queued so that popping it never brings the count below 0,
+            // taking the lock orders the increment with a worker checking it before sleeping
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            ++_queued;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+            _queues[index]->tasks.push_back(std::move(task));
+        }
+        _wakeUp.notify_one();
+    }
+
+    bool TaskPool::pop(Task &task) {
+        if (_queued == 0) {
+            return false;
+        }
+
+        const std::size_t count = _queues.size();
+        const std::size_t own   = workerPool == this ? static_cast<std::size_t>(workerIndex) : count - 1;
+
+        // Newest task of our own queue first, it is the most likely to still be in cache
+        {
+            std::lock_guard<std::mutex> lock(_queues[own]->mutex);
+            auto &tasks = _queues[own]->tasks;
+            if (!tasks.empty()) {
+                task = std::move(tasks.back());
+                tasks.pop_back();
+                --_queued;
+                return true;
+            }
+        }
+
+        // Then steal the oldest task of another queue, it is the most likely to fan out more work
+        const std::size_t start = _nextQueue++;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto &queue = _queues[(start + i) % count];
+            if (queue.get() == _queues[own].get()) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (!queue->tasks.empty()) {
+                task = std::move(queue->tasks.front());
+                queue->tasks.pop_front();
+                --_queued;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void TaskPool::run(Task &task) {
+        try {
+            task.function();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(task.group->_errorMutex);
+            if (!task.group->_error) {
+                task.group->_error = std::current_exception();
+            }
+        }
+        // Release the captures before the group can be done with, then leave the group alone,
+        // it can be destroyed as soon as pending reaches 0
+        task.function = nullptr;
+        --task.group->_pending;
+    }
+
+    void TaskPool::work(const unsigned int index) {
+        workerIndex = static_cast<int>(index);
+        workerPool  = this;
+
+        Task task{};
+        while (true) {
+            if (pop(task)) {
+                run(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _wakeUp.wait(lock, [this]() { return _stopping || _queued > 0; });
+            if (_stopping) {
+                return;
+            }
+        }
+    }
+
+    // endregion
+
+    // region Group
+
+    TaskGroup::TaskGroup(TaskPool &pool) :
+        _pool(pool) {}
+
+    TaskGroup::~TaskGroup() {
+        // Tasks hold a pointer to the group
+        while (_pending > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    void TaskGroup::run(std::function<void()> task) {
+        ++_pending;
+        _pool.push(TaskPool::Task{std::move(task), this});
+    }
+
+    void TaskGroup::wait() {
+        TaskPool::Task task{};
+        while (_pending > 0) {
+            // Help instead of blocking, the tasks we wait on may be queued behind us
+            if (_pool.pop(task)) {
+                _pool.run(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (_error) {
+            auto error = _error;
+            _error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    // endregion
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace psychic_ui {
+
+    class TaskGroup;
+
+    /**
+     * Work stealing thread pool
+     *
+     * Every worker has its own queue, it runs its newest task first and steals the oldest
+     * task of another worker when its queue is empty. Tasks are grouped in a TaskGroup and a
+     * thread waiting on a group runs queued tasks instead of blocking, so tasks can fan out
+     * more tasks and wait on them (ex: recursive tree walks) without starving the pool.
+     */
+    class TaskPool {
+        friend class TaskGroup;
+
+    public:
+        /**
+         * Shared pool, sized for the machine
+         */
+        static std::shared_ptr<TaskPool> getInstance();
+
+        /**
+         * @param threadCount Number of worker threads, the thread waiting on a group also works
+         *                    so with 0 every task runs on the thread waiting on it
+         */
+        explicit TaskPool(unsigned int threadCount = defaultThreadCount());
+        ~TaskPool();
+
+        TaskPool(const TaskPool &) = delete;
+        TaskPool &operator=(const TaskPool &) = delete;
+
+        unsigned int threadCount() const;
+
+        /**
+         * One less than the hardware threads, the thread waiting on the tasks is the last one
+         */
+        static unsigned int defaultThreadCount();
+
+    protected:
+        static std::shared_ptr<TaskPool> instance;
+
+        struct Task {
+            std::function<void()> function;
+            TaskGroup             *group;
+        };
+
+        struct Queue {
+            std::mutex       mutex{};
+            std::deque<Task> tasks{};
+        };
+
+        std::vector<std::thread>            _threads{};
+        std::vector<std::unique_ptr<Queue>> _queues{};
+        std::atomic<unsigned int>           _queued{0};
+        std::atomic<unsigned int>           _nextQueue{0};
+        std::mutex                          _sleepMutex{};
+        std::condition_variable             _wakeUp{};
+        bool                                _stopping{false};
+
+        void push(Task task);
+
+        /**
+         * Pop a task from the queue of the calling worker, or steal one from another queue
+         * @param task Receives the task
+         * @return Whether a task was found
+         */
+        bool pop(Task &task);
+
+        void run(Task &task);
+        void work(unsigned int index);
+    };
+
+    /**
+     * Set of tasks running on a TaskPool that can be waited on
+     * Tasks must not outlive the group, wait() has to be called before destroying it.
+     */
+    class TaskGroup {
+        friend class TaskPool;
+
+    public:
+        explicit TaskGroup(TaskPool &pool);
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup &) = delete;
+        TaskGroup &operator=(const TaskGroup &) = delete;
+
+        /**
+         * Queue a task, it can run on any thread of the pool
+         * @param task
+         */
+        void run(std::function<void()> task);
+
+        /**
+         * Run queued tasks until every task of the group is done
+         * Rethrows the first exception thrown by a task of the group
+         */
+        void wait();
+
+    protected:
+        TaskPool                  &_pool;
+        std::atomic<unsigned int> _pending{0};
+        std::mutex                _errorMutex{};
+        std::exception_ptr        _error{nullptr};
+    };
+}
@@ -4,8 +4,11 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  */
-#include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <iostream>
+#include <iterator>
+#include <unicode/utf16.h>
 #include "TextBox.hpp"
 
 namespace psychic_ui {
@@ -62,46 +65,221 @@ namespace psychic_ui {
         wordIterator->setText(*_text);
         sentenceIterator->setText(*_text);
 
-        // Text had changed, recalculate line breaks
+        // Text had changed, measure everything again
+        _paragraphs.clear();
+        _measuredTypeface = _paint ? _paint->getTypeface() : nullptr;
+        _measuredTextSize = _paint ? _paint->getTextSize() : 0.0f;
+        splitParagraphs(0, static_cast<unsigned int>(_text->length()), _paragraphs);
+
+        calculate();
+    }
+
+    void TextBox::updateText(unsigned int start, unsigned int removed, unsigned int inserted) {
+        if (_paragraphs.empty() || fontChanged()) {
+            updateText();
+            return;
+        }
+
+        lineIterator->setText(*_text);
+        wordIterator->setText(*_text);
+        sentenceIterator->setText(*_text);
+
+        // Paragraphs touched by the edit, in the previous text, the last one is the one
+        // that contained the end of the removed text since its line feed is still there
+        const std::size_t first = paragraphAt(start);
+        std::size_t       last  = paragraphAt(start + removed);
+        if (last + 2 == _paragraphs.size() && _paragraphs.back().length == 0) {
+            // Splitting up to the end of the text gives the empty last paragraph again
+            ++last;
+        }
+        const Paragraph   &end  = _paragraphs[last];
+        const long        delta = static_cast<long>(inserted) - static_cast<long>(removed);
+
+        std::vector<Paragraph> paragraphs{};
+        splitParagraphs(
+            _paragraphs[first].start,
+            static_cast<unsigned int>(static_cast<long>(end.start + end.length) + delta),
+            paragraphs
+        );
+
+        // The following paragraphs only move, their advances and lines are still good
+        for (std::size_t i = last + 1; i < _paragraphs.size(); ++i) {
+            _paragraphs[i].start = static_cast<unsigned int>(static_cast<long>(_paragraphs[i].start) + delta);
+        }
+
+        _paragraphs.erase(_paragraphs.begin() + first, _paragraphs.begin() + last + 1);
+        _paragraphs.insert(
+            _paragraphs.begin() + first,
+            std::make_move_iterator(paragraphs.begin()),
+            std::make_move_iterator(paragraphs.end())
+        );
+
         calculate();
     }
 
     void TextBox::calculate() {
         _lineStarts.clear();
 
-        if (_box.width() <= 0 || _text->length() == 0) {
+        if (!_text) {
             return;
         }
 
-        unsigned int lastBreak = 0;
+        if (fontChanged()) {
+            _measuredTypeface = _paint->getTypeface();
+            _measuredTextSize = _paint->getTextSize();
+            for (auto &paragraph : _paragraphs) {
+                measure(paragraph);
+            }
+        }
 
-        _lineStarts.push_back(lastBreak);
+        if (_box.width() <= 0 || _text->length() == 0) {
+            return;
+        }
 
         if (_mode == TextBoxMode::OneLine) {
+            _lineStarts.push_back(0);
             return;
         }
 
-        do {
-            unsigned int nextBreak = nextLineBreak(lastBreak);
+        // Only the paragraphs that were not broken for this width need to be broken,
+        // the others only contribute their line starts
+        for (auto &paragraph : _paragraphs) {
+            if (paragraph.brokenWidth != _box.width()) {
+                breakLines(paragraph);
+            }
+            for (auto lineStart : paragraph.lineStarts) {
+                _lineStarts.push_back(paragraph.start + lineStart);
+            }
+        }
+    }
 
-            //if (nextBreak == 0) {
-            //    // Skia's breakText broke down, we're probably narrower than a character
-            //    // Just assume we're one character wide so that our height is equal to the
-            //    // length of the text
-            //    count = static_cast<unsigned int>(_text->length());
-            //    break;
-            //}
+    void TextBox::splitParagraphs(unsigned int from, unsigned int to, std::vector<Paragraph> &paragraphs) const {
+        const auto length = static_cast<unsigned int>(_text->length());
+
+        while (from < to) {
+            auto lineFeed = _text->indexOf('\n', static_cast<int32_t>(from), static_cast<int32_t>(to - from));
+            auto end      = lineFeed != -1 ? static_cast<unsigned int>(lineFeed) + 1 : to;
+
+            Paragraph paragraph{};
+            paragraph.start  = from;
+            paragraph.length = end - from;
+            measure(paragraph);
+            paragraphs.push_back(std::move(paragraph));
 
-            // Index wise there is no difference between the end of string and a
-            // final line return, so we have to check unfortunately because we don't
-            // want the end of the string being considered as the start of a new line.
-            if (nextBreak < _text->length() || _text->charAt(nextBreak - 1) == '\n') {
-                _lineStarts.push_back(nextBreak);
+            from = end;
+        }
+
+        // The text after the last line feed is a paragraph even when empty,
+        // a final line return still makes a new line
+        if (to == length && (paragraphs.empty() || _text->charAt(static_cast<int32_t>(to) - 1) == '\n')) {
+            Paragraph paragraph{};
+            paragraph.start = to;
+            paragraphs.push_back(std::move(paragraph));
+        }
+    }
+
+    void TextBox::measure(Paragraph &paragraph) const {
+        paragraph.advances.assign(paragraph.length, 0.0f);
+        paragraph.brokenWidth = -1.0f;
+
+        // The line feed doesn't take any room
+        unsigned int count = paragraph.length;
+        if (count > 0 && _text->charAt(static_cast<int32_t>(paragraph.start + count - 1)) == '\n') {
+            --count;
+        }
+        if (count == 0 || !_paint) {
+            return;
+        }
+
+        SkFont                 font   = SkFont::LEGACY_ExtractFromPaint(*_paint);
+        const UChar            *units = _text->getBuffer() + paragraph.start;
+        std::vector<SkGlyphID> glyphs(count);
+        int                    glyphCount = font.textToGlyphs(units, count * sizeof(UChar), SkTextEncoding::kUTF16, glyphs.data(), static_cast<int>(count));
+        std::vector<SkScalar>  widths(static_cast<std::size_t>(glyphCount));
+        font.getWidths(glyphs.data(), glyphCount, widths.data());
+
+        // One glyph per code point, the advance goes to its first code unit
+        int glyph = 0;
+        for (unsigned int i = 0; i < count && glyph < glyphCount; ++i) {
+            if (U16_IS_TRAIL(units[i]) && i > 0 && U16_IS_LEAD(units[i - 1])) {
+                continue;
+            }
+            paragraph.advances[i] = widths[glyph++];
+        }
+    }
+
+    void TextBox::breakLines(Paragraph &paragraph) const {
+        const float maxWidth = _box.width();
+
+        paragraph.lineStarts.assign(1, 0);
+        paragraph.brokenWidth = maxWidth;
+
+        unsigned int count = paragraph.length;
+        if (count > 0 && _text->charAt(static_cast<int32_t>(paragraph.start + count - 1)) == '\n') {
+            --count;
+        }
+
+        const UChar  *units    = _text->getBuffer() + paragraph.start;
+        unsigned int lineStart = 0;
+        float        width     = 0.0f;
+        for (unsigned int i = 0; i < count; ++i) {
+            width += paragraph.advances[i];
+
+            // A line always gets at least one character and spaces hang past the edge
+            if (width <= maxWidth || i == lineStart || units[i] == ' ') {
+                continue;
+            }
+
+            // The character at i doesn't fit, break at the last opportunity before it
+            unsigned int lineBreak = i;
+            if (!lineIterator->isBoundary(static_cast<int32_t>(paragraph.start + i))) {
+                int32_t opportunity = lineIterator->preceding(static_cast<int32_t>(paragraph.start + i));
+                if (opportunity != icu::BreakIterator::DONE && opportunity > static_cast<int32_t>(paragraph.start + lineStart)) {
+                    lineBreak = static_cast<unsigned int>(opportunity) - paragraph.start;
+                }
             }
 
-            lastBreak = nextBreak;
+            // Never split a surrogate pair
+            if (U16_IS_TRAIL(units[lineBreak]) && U16_IS_LEAD(units[lineBreak - 1])) {
+                if (lineBreak - 1 > lineStart) {
+                    --lineBreak;
+                } else if (++lineBreak >= count) {
+                    break;
+                }
+            }
+
+            paragraph.lineStarts.push_back(lineBreak);
+            lineStart = lineBreak;
+
+            // Start measuring again from the new line
+            width = 0.0f;
+            i     = lineBreak - 1;
+        }
+    }
+
+    std::size_t TextBox::paragraphAt(unsigned int index) const {
+        auto paragraph = std::upper_bound(
+            _paragraphs.begin(), _paragraphs.end(), index,
+            [](unsigned int i, const Paragraph &p) { return i < p.start; }
+        );
+        return paragraph == _paragraphs.begin() ? 0 : static_cast<std::size_t>(paragraph - _paragraphs.begin()) - 1;
+    }
+
+    float TextBox::advance(unsigned int from, unsigned int to) const {
+        float x = 0.0f;
+        for (std::size_t p = paragraphAt(from); p < _paragraphs.size() && from < to; ++p) {
+            const Paragraph    &paragraph = _paragraphs[p];
+            const unsigned int end        = std::min(to, paragraph.start + paragraph.length);
+            for (unsigned int i = from; i < end; ++i) {
+                x += paragraph.advances[i - paragraph.start];
+            }
+            from = end;
+        }
+        return x;
+    }
 
-        } while (lastBreak < _text->length());
+    bool TextBox::fontChanged() const {
+        return _paint && (_paint->getTypeface() != _measuredTypeface || _paint->getTextSize() != _measuredTextSize);
     }
 
     //unsigned int TextBox::countLines() const {
@@ -136,32 +314,8 @@ namespace psychic_ui {
     }
 
     unsigned int TextBox::nextLineBreak(int start) const {
-        icu::UnicodeString remaining = _text->tempSubStringBetween(start, _text->length());
-        std::string        str;
-        remaining.toUTF8String(str);
-
-        // Start by finding where the text would cut at max if we were not to use UnicodeString
-        // TODO: Fix deprecated thing
-        SkFont font    = SkFont::LEGACY_ExtractFromPaint(*_paint);
-        auto   advance = static_cast<unsigned int>(font.breakText(str.c_str(), str.size(), SkTextEncoding::kUTF8, _box.width()));
-
-        if (_mode == TextBoxMode::OneLine || advance == 0) {
-            return advance;
-        }
-
-        // Check if a line return exists before that
-        auto lineBreak = _text->indexOf('\n', start, advance);
-        if (lineBreak != -1) {
-            return static_cast<unsigned int>(lineBreak) + 1;
-        }
-
-        unsigned int maxBreak = start + advance;
-        if (lineIterator->isBoundary(maxBreak)) {
-            return maxBreak;
-        } else {
-            int lastBreak = lineIterator->preceding(maxBreak);
-            return lastBreak != icu::BreakIterator::DONE && lastBreak > start ? static_cast<unsigned int>(lastBreak) : maxBreak;
-        }
+        auto next = std::upper_bound(_lineStarts.begin(), _lineStarts.end(), static_cast<unsigned int>(start));
+        return next != _lineStarts.end() ? *next : static_cast<unsigned int>(_text->length());
     }
 
     void TextBox::visit(const TextBoxVisitor &visitor) const {
@@ -258,16 +412,8 @@ namespace psychic_ui {
     }
 
     unsigned int TextBox::lineFromIndex(unsigned int index) const {
-        unsigned int line = 0;
-
-        for (unsigned int i = 0; i < _lineStarts.size(); ++i) {
-            if (index < _lineStarts[i]) {
-                break;
-            }
-            line = i;
-        }
-
-        return line;
+        auto next = std::upper_bound(_lineStarts.begin(), _lineStarts.end(), index);
+        return next == _lineStarts.begin() ? 0 : static_cast<unsigned int>(next - _lineStarts.begin()) - 1;
     }
 
     std::pair<unsigned int, unsigned int> TextBox::wordAtIndex(unsigned int index) const {
@@ -315,16 +461,20 @@ namespace psychic_ui {
         int lineStart = _lineStarts[line];
         int lineEnd   = line < _lineStarts.size() - 1 ? _lineStarts[line + 1] - 1 : static_cast<unsigned int>(_text->length());
 
-        std::string str{};
-        _text->tempSubStringBetween(lineStart, lineEnd).toUTF8String(str);
-
-        std::vector<SkScalar> widths(str.size());
-        _paint->getTextWidths(str.c_str(), str.size(), &widths.front());
-        unsigned int pos    = 0;
-        float        xCheck = x + _box.fLeft;
-        float        acc    = 0.0f;
-        for (pos = 0; pos < widths.size(); ++pos) {
-            float width     = widths[pos];
+        std::size_t paragraph = paragraphAt(static_cast<unsigned int>(lineStart));
+        int         pos       = lineStart;
+        float       xCheck    = x + _box.fLeft;
+        float       acc       = 0.0f;
+        for (; pos < lineEnd; ++pos) {
+            // Only one line mode has lines spanning paragraphs
+            while (pos >= static_cast<int>(_paragraphs[paragraph].start + _paragraphs[paragraph].length)) {
+                ++paragraph;
+            }
+            float width = _paragraphs[paragraph].advances[pos - _paragraphs[paragraph].start];
+            if (width == 0.0f) {
+                // Second half of a surrogate pair or zero width mark, the caret doesn't stop there
+                continue;
+            }
             float halfWidth = width * 0.5f;
             if (xCheck < acc + halfWidth) {
                 break;
@@ -332,24 +482,14 @@ namespace psychic_ui {
             acc += width;
         }
 
-        return lineStart + pos;
+        return static_cast<unsigned int>(pos);
     }
 
     std::pair<unsigned int, unsigned int> TextBox::posFromIndex(unsigned int index) const {
-        unsigned int line      = 0;
-        unsigned int lineStart = 0;
-
-        for (unsigned int i = 0; i < _lineStarts.size(); ++i) {
-            if (index < _lineStarts[i]) {
-                break;
-            }
-            line      = i;
-            lineStart = _lineStarts[i];
-        }
+        unsigned int line      = lineFromIndex(index);
+        unsigned int lineStart = _lineStarts.empty() ? 0 : _lineStarts[line];
 
-        std::string str{};
-        _text->tempSubStringBetween(lineStart, index).toUTF8String(str);
-        auto x = static_cast<int>(std::round(_paint->measureText(str.c_str(), str.size())));
+        auto x = static_cast<int>(std::round(advance(lineStart, index)));
 
         return std::make_pair(line, x);
     }
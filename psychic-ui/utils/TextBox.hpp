@@ -135,7 +135,21 @@ namespace psychic_ui {
         void updateText();
 
         /**
-         * Calculate line breal
+         * Same as updateText() after an edit of the text, only the paragraphs
+         * touched by the edit are measured and broken into lines again
+         *
+         * @param start Index of the edit
+         * @param removed Number of code units removed at start
+         * @param inserted Number of code units inserted at start, after the removal
+         */
+        void updateText(unsigned int start, unsigned int removed, unsigned int inserted);
+
+        /**
+         * Calculate line breaks
+         *
+         * Glyph advances are cached per paragraph, so this only measures the text again
+         * when the font changed, and only breaks again the paragraphs that were broken
+         * for another box width.
          */
         void calculate();
 
@@ -168,6 +182,9 @@ namespace psychic_ui {
         /**
          * Get the next line break from the provided start position
          *
+         * No calculations are involved but the TextBox must be up to date
+         * (by calling `calculate`) for this method to work.
+         *
          * @param start Where to start looking for a line break
          * @return Index of the next line break from start
          */
@@ -296,7 +313,69 @@ namespace psychic_ui {
 
         void visit(const TextBoxVisitor &visitor) const;
 
+        /**
+         * Text between two line feeds, with the advance of every code unit
+         */
+        struct Paragraph {
+            /**
+             * Index of the first code unit
+             */
+            unsigned int              start{0};
+            /**
+             * Number of code units, including the line feed ending the paragraph
+             * Every paragraph but the last one ends with a line feed
+             */
+            unsigned int              length{0};
+            std::vector<float>        advances{};
+            /**
+             * Line starts, relative to the paragraph start
+             */
+            std::vector<unsigned int> lineStarts{};
+            /**
+             * Box width the lines were broken for, negative when they have to be broken again
+             */
+            float                     brokenWidth{-1.0f};
+        };
+
+        /**
+         * Split the text between two paragraph boundaries into measured paragraphs
+         * @param from Start of a paragraph
+         * @param to End of a paragraph (after its line feed) or the end of the text
+         * @param paragraphs Where to append the paragraphs
+         */
+        void splitParagraphs(unsigned int from, unsigned int to, std::vector<Paragraph> &paragraphs) const;
+
+        /**
+         * Cache the advances of the code units of a paragraph
+         */
+        void measure(Paragraph &paragraph) const;
+
+        /**
+         * Break a paragraph into lines that fit the box, using the line iterator for break opportunities
+         */
+        void breakLines(Paragraph &paragraph) const;
+
+        /**
+         * Index of the paragraph containing a code unit
+         */
+        std::size_t paragraphAt(unsigned int index) const;
+
+        /**
+         * Width of the text between two indices, from the cached advances
+         */
+        float advance(unsigned int from, unsigned int to) const;
+
+        /**
+         * Whether the paint's font changed since the paragraphs were measured
+         */
+        bool fontChanged() const;
+
         // Calculated values
         std::vector<unsigned int> _lineStarts{};
+        std::vector<Paragraph>    _paragraphs{};
+
+        // Font the paragraphs were measured with
+        const SkTypeface *_measuredTypeface{nullptr};
+        float            _measuredTextSize{0.0f};
     };
 }
@@ -0,0 +1,68 @@
+#include "YogaNodePool.hpp"
+#include <mutex>
+#include <vector>
+
+namespace psychic_ui {
+
+    const std::size_t YogaNodePool::maxPooled = 16384;
+
+    namespace {
+        struct Nodes {
+            std::mutex             mutex{};
+            std::vector<YGNodeRef> nodes{};
+        };
+
+        Nodes &nodes() {
+            // Never destroyed, divs can be destroyed during static destruction
+            static auto *nodes = new Nodes();
+            return *nodes;
+        }
+    }
+
+    YGNodeRef YogaNodePool::acquire() {
+        {
+            Nodes                       &pool = nodes();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (!pool.nodes.empty()) {
+                YGNodeRef node = pool.nodes.back();
+                pool.nodes.pop_back();
+                return node;
+            }
+        }
+        return YGNodeNew();
+    }
+
+    void YogaNodePool::release(YGNodeRef node) {
+        // Children still attached are being destroyed along with their parent,
+        // detach them from the back, it doesn't shift the others
+        for (auto count = YGNodeGetChildCount(node); count > 0; --count) {
+            YGNodeRemoveChild(node, YGNodeGetChild(node, count - 1));
+        }
+        YGNodeReset(node);
+
+        {
+            Nodes                       &pool = nodes();
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if (pool.nodes.size() < maxPooled) {
+                pool.nodes.push_back(node);
+                return;
+            }
+        }
+        YGNodeFree(node);
+    }
+
+    std::size_t YogaNodePool::size() {
+        Nodes                       &pool = nodes();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        return pool.nodes.size();
+    }
+
+    void YogaNodePool::clear() {
+        Nodes                       &pool = nodes();
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        for (auto node: pool.nodes) {
+            YGNodeFree(node);
+        }
+        pool.nodes.clear();
+    }
+}
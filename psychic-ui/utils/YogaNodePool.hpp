@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <yoga/Yoga.h>
+
+namespace psychic_ui {
+
+    /**
+     * Recycles the Yoga nodes of destroyed divs
+     *
+     * Released nodes are detached from their children and reset to their defaults, then
+     * handed out again instead of allocating a new node. At most `maxPooled` nodes are kept,
+     * the others are freed.
+     */
+    class YogaNodePool {
+    public:
+        static const std::size_t maxPooled;
+
+        /**
+         * Reset node from the pool, or a new node when the pool is empty
+         */
+        static YGNodeRef acquire();
+
+        /**
+         * Give back a node, it must not have a parent anymore
+         * @param node
+         */
+        static void release(YGNodeRef node);
+
+        /**
+         * Number of nodes waiting to be reused
+         */
+        static std::size_t size();
+
+        /**
+         * Free every pooled node
+         */
+        static void clear();
+    };
+}
@@ -5,7 +5,7 @@
 #include <cmath>
 #include <yoga/Yoga.h>
 
-YGDirection YogaDirectionFromString(std::string direction, YGDirection fallback = YGDirectionInherit) {
+inline YGDirection YogaDirectionFromString(std::string direction, YGDirection fallback = YGDirectionInherit) {
     std::transform(direction.begin(), direction.end(), direction.begin(), ::tolower);
     if (direction == "inherit") { return YGDirectionInherit; }
     else if (direction == "ltr") { return YGDirectionLTR; }
@@ -13,7 +13,7 @@ YGDirection YogaDirectionFromString(std::string direction, YGDirection fallback
     else { return fallback; };
 };
 
-YGFlexDirection YogaFlexDirectionFromString(std::string dlexDirection, YGFlexDirection fallback = YGFlexDirectionColumn) {
+inline YGFlexDirection YogaFlexDirectionFromString(std::string dlexDirection, YGFlexDirection fallback = YGFlexDirectionColumn) {
     std::transform(dlexDirection.begin(), dlexDirection.end(), dlexDirection.begin(), ::tolower);
     if (dlexDirection == "column") { return YGFlexDirectionColumn; }
     else if (dlexDirection == "columnreverse") { return YGFlexDirectionColumnReverse; }
@@ -22,7 +22,7 @@ YGFlexDirection YogaFlexDirectionFromString(std::string dlexDirection, YGFlexDir
     else { return fallback; };
 };
 
-YGJustify YogaJustifyFromString(std::string justify, YGJustify fallback = YGJustifyFlexStart) {
+inline YGJustify YogaJustifyFromString(std::string justify, YGJustify fallback = YGJustifyFlexStart) {
     std::transform(justify.begin(), justify.end(), justify.begin(), ::tolower);
     if (justify == "start") { return YGJustifyFlexStart; }
     else if (justify == "center") { return YGJustifyCenter; }
@@ -32,7 +32,7 @@ YGJustify YogaJustifyFromString(std::string justify, YGJustify fallback = YGJust
     else { return fallback; };
 };
 
-YGAlign YogaAlignFromString(std::string align, YGAlign fallback = YGAlignAuto) {
+inline YGAlign YogaAlignFromString(std::string align, YGAlign fallback = YGAlignAuto) {
     std::transform(align.begin(), align.end(), align.begin(), ::tolower);
     if (align == "auto") { return YGAlignAuto; }
     else if (align == "start") { return YGAlignFlexStart; }
@@ -45,14 +45,14 @@ YGAlign YogaAlignFromString(std::string align, YGAlign fallback = YGAlignAuto) {
     else { return fallback; };
 };
 
-YGPositionType YogaPositionFromString(std::string position, YGPositionType fallback = YGPositionTypeRelative) {
+inline YGPositionType YogaPositionFromString(std::string position, YGPositionType fallback = YGPositionTypeRelative) {
     std::transform(position.begin(), position.end(), position.begin(), ::tolower);
     if (position == "relative") { return YGPositionTypeRelative; }
     else if (position == "absolute") { return YGPositionTypeAbsolute; }
     else { return fallback; };
 };
 
-YGWrap YogaWrapFromString(std::string wrap, YGWrap fallback = YGWrapNoWrap) {
+inline YGWrap YogaWrapFromString(std::string wrap, YGWrap fallback = YGWrapNoWrap) {
     std::transform(wrap.begin(), wrap.end(), wrap.begin(), ::tolower);
     if (wrap == "nowrap") { return YGWrapNoWrap; }
     else if (wrap == "wrap") { return YGWrapWrap; }
@@ -60,7 +60,7 @@ YGWrap YogaWrapFromString(std::string wrap, YGWrap fallback = YGWrapNoWrap) {
     else { return fallback; };
 };
 
-YGOverflow YogaOverflowFromString(std::string overflow, YGOverflow fallback = YGOverflowVisible) {
+inline YGOverflow YogaOverflowFromString(std::string overflow, YGOverflow fallback = YGOverflowVisible) {
     std::transform(overflow.begin(), overflow.end(), overflow.begin(), ::tolower);
     if (overflow == "visible") { return YGOverflowVisible; }
     else if (overflow == "hidden") { return YGOverflowHidden; }
@@ -68,13 +68,13 @@ YGOverflow YogaOverflowFromString(std::string overflow, YGOverflow fallback = YG
     else { return fallback; };
 };
 
-YGDisplay YogaDisplayFromString(std::string display, YGDisplay fallback = YGDisplayFlex) {
+inline YGDisplay YogaDisplayFromString(std::string display, YGDisplay fallback = YGDisplayFlex) {
     std::transform(display.begin(), display.end(), display.begin(), ::tolower);
     if (display == "flex") { return YGDisplayFlex; }
     else if (display == "none") { return YGDisplayNone; }
     else { return fallback; };
 };
 
-float YogaPercent(float value) {
+inline float YogaPercent(float value) {
     return !std::isnan(value) ? value * 100.f : value;
 }
@@ -0,0 +1,633 @@
+#ifdef WITH_HEADLESS
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "catch2/catch.hpp"
+#include "SkPixmap.h"
+#include "SkSurface.h"
+#include <psychic-ui/applications/HeadlessApplication.hpp>
+#include <psychic-ui/Window.hpp>
+#include <psychic-ui/Shape.hpp>
+#include <psychic-ui/components/Box.hpp>
+#include <psychic-ui/components/DataContainer.hpp>
+#include <psychic-ui/components/Scroller.hpp>
+#include <psychic-ui/components/VirtualDataContainer.hpp>
+#include <psychic-ui/utils/LayerCache.hpp>
+#include <psychic-ui/utils/TaskPool.hpp>
+
+using namespace psychic_ui;
+
+namespace {
+    /**
+     * Change Window::rasterTileSize for a scope,
+     * restored even when a failing assertion leaves the scope early
+     */
+    struct RasterTileSize {
+        const int previous;
+
+        explicit RasterTileSize(int size) :
+            previous(Window::rasterTileSize) {
+            Window::rasterTileSize = size;
+        }
+
+        ~RasterTileSize() {
+            Window::rasterTileSize = previous;
+        }
+    };
+
+    /**
+     * Item that can be compared but not ordered
+     */
+    struct UnorderedItem {
+        int value;
+
+        bool operator==(const UnorderedItem &other) const { return value == other.value; }
+        bool operator!=(const UnorderedItem &other) const { return value != other.value; }
+    };
+}
+
+SCENARIO("windows can be rendered without a display") {
+    auto application = std::make_unique<HeadlessApplication>();
+    application->init();
+
+    GIVEN("a headless window") {
+        auto window = std::make_shared<Window>("headless");
+        window->setWindowSize(64, 48);
+        application->open(window);
+        auto systemWindow = application->systemWindow(window);
+        REQUIRE(systemWindow != nullptr);
+
+        WHEN("a frame is rendered") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            REQUIRE(application->step() == 1);
+
+            THEN("the frame can be snapshotted") {
+                auto image = systemWindow->snapshot();
+                REQUIRE(image != nullptr);
+                REQUIRE(image->width() == 64);
+                REQUIRE(image->height() == 48);
+
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(32, 24) == 0xFFFF0000);
+            }
+        }
+
+        WHEN("synthetic events are queued") {
+            auto div = window->appContainer()->add<Div>();
+            div->style()
+               ->set(position, "absolute")
+               ->set(left, 10)
+               ->set(top, 10)
+               ->set(width, 20)
+               ->set(height, 20);
+
+            int clicks = 0;
+            div->onClick.subscribe([&clicks]() { ++clicks; });
+
+            application->step();
+            systemWindow->click(15, 15);
+            REQUIRE(systemWindow->hasPendingEvents());
+
+            THEN("the main loop dispatches them and returns once drained") {
+                application->mainloop();
+                REQUIRE_FALSE(systemWindow->hasPendingEvents());
+                REQUIRE(clicks == 1);
+            }
+        }
+
+        WHEN("only part of the window changes") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            auto div = window->appContainer()->add<Div>();
+            div->style()
+               ->set(position, "absolute")
+               ->set(left, 10)
+               ->set(top, 10)
+               ->set(width, 20)
+               ->set(height, 20)
+               ->set(backgroundColor, 0xFF00FF00);
+            application->step();
+
+            THEN("nothing is drawn until something is damaged") {
+                REQUIRE(window->damageRect().isEmpty());
+                REQUIRE_FALSE(window->needsRender());
+                REQUIRE_FALSE(window->drawAll());
+            }
+
+            THEN("invalidating the tree requests a render") {
+                div->style()->set(backgroundColor, 0xFF0000FF);
+                REQUIRE(window->needsRender());
+                REQUIRE(window->drawAll());
+                REQUIRE_FALSE(window->needsRender());
+            }
+
+            THEN("only the changed div is damaged and redrawn") {
+                div->style()->set(backgroundColor, 0xFF0000FF);
+                window->updateInvalidStyles();
+                SkIRect damage = window->damageRect();
+                REQUIRE(damage.contains(SkIRect::MakeXYWH(10, 10, 20, 20)));
+                REQUIRE_FALSE(damage.contains(SkIRect::MakeXYWH(40, 30, 1, 1)));
+
+                REQUIRE(window->drawAll());
+                REQUIRE(window->damageRect().isEmpty());
+
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFF0000FF);
+                REQUIRE(pixmap.getColor(40, 30) == 0xFFFF0000);
+            }
+        }
+
+        WHEN("a div has uneven borders") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            auto div = window->appContainer()->add<Div>();
+            div->style()
+               ->set(position, "absolute")
+               ->set(left, 10)
+               ->set(top, 10)
+               ->set(width, 20)
+               ->set(height, 20)
+               ->set(borderLeft, 2)
+               ->set(borderLeftColor, 0xFF00FF00);
+            application->step();
+
+            THEN("they are drawn along the div") {
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(10, 20) == 0xFF00FF00);
+                REQUIRE(pixmap.getColor(11, 20) == 0xFF00FF00);
+                REQUIRE(pixmap.getColor(1, 20) == 0xFFFF0000);
+                REQUIRE(pixmap.getColor(12, 20) == 0xFFFF0000);
+            }
+        }
+
+        WHEN("a div has no background") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            auto div = window->appContainer()->add<Div>();
+            div->style()
+               ->set(position, "absolute")
+               ->set(left, 10)
+               ->set(top, 10)
+               ->set(width, 20)
+               ->set(height, 20);
+            auto inner = div->add<Div>();
+            inner->style()->set(grow, 1);
+            application->step();
+
+            THEN("the parent shows through") {
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(20, 20) == 0xFFFF0000);
+                REQUIRE(pixmap.getColor(10, 10) == 0xFFFF0000);
+                REQUIRE(pixmap.getColor(40, 30) == 0xFFFF0000);
+            }
+        }
+
+        WHEN("a view is covered by an opaque modal") {
+            int  draws = 0;
+            auto view  = window->appContainer()->add<Shape>([&draws](Shape *, SkCanvas *) { ++draws; });
+            view->style()->set(grow, 1);
+            auto dialog = window->modalContainer()->add<Div>();
+            dialog->style()->set(grow, 1)->set(backgroundColor, 0xFF0000FF);
+            application->step();
+            REQUIRE(draws == 1);
+
+            THEN("the view is not drawn while the modal is shown") {
+                window->modalContainer()->style()->set(visible, true);
+                application->step();
+                REQUIRE(draws == 1);
+
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(32, 24) == 0xFF0000FF);
+
+                window->invalidateRender();
+                application->step();
+                REQUIRE(draws == 1);
+            }
+
+            THEN("the view is drawn again once the modal is hidden") {
+                window->modalContainer()->style()->set(visible, true);
+                application->step();
+                window->modalContainer()->style()->set(visible, false);
+                application->step();
+                REQUIRE(draws == 2);
+            }
+
+            THEN("a translucent modal doesn't hide the view") {
+                dialog->style()->set(backgroundColor, 0x800000FF);
+                window->modalContainer()->style()->set(visible, true);
+                application->step();
+                REQUIRE(draws == 2);
+            }
+
+            THEN("an overlay without a background doesn't hide the view") {
+                dialog->style()->set(backgroundColor, 0xFF0000FF);
+                dialog->style()->set(visible, false);
+                auto overlay = window->modalContainer()->add<Div>();
+                overlay->style()
+                       ->set(position, "absolute")
+                       ->set(left, 0)
+                       ->set(top, 0)
+                       ->set(widthPercent, 1.0f)
+                       ->set(heightPercent, 1.0f);
+                window->modalContainer()->style()->set(visible, true);
+                application->step();
+                REQUIRE(draws == 2);
+            }
+        }
+
+        WHEN("a frame is recorded") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            application->step();
+            auto displayList = window->displayList();
+
+            THEN("its display list can be replayed on another surface") {
+                REQUIRE(displayList != nullptr);
+                REQUIRE(displayList->cullRect().contains(SkRect::MakeWH(64, 48)));
+
+                auto surface = SkSurface::MakeRasterN32Premul(64, 48);
+                surface->getCanvas()->drawPicture(displayList);
+                SkPixmap pixmap;
+                REQUIRE(surface->makeImageSnapshot()->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(32, 24) == 0xFFFF0000);
+            }
+
+            THEN("it is kept until something is damaged") {
+                REQUIRE_FALSE(window->drawAll());
+                REQUIRE(window->displayList() == displayList);
+            }
+
+            THEN("only the damaged area is recorded again") {
+                auto div = window->appContainer()->add<Div>();
+                div->style()
+                   ->set(position, "absolute")
+                   ->set(left, 10)
+                   ->set(top, 10)
+                   ->set(width, 20)
+                   ->set(height, 20);
+                application->step();
+                REQUIRE(window->displayList() != displayList);
+                REQUIRE_FALSE(window->displayList()->cullRect().contains(SkRect::MakeWH(64, 48)));
+            }
+        }
+
+        WHEN("frames are rasterized in tiles") {
+            RasterTileSize tileSize{16};
+            window->setRasterTaskPool(std::make_shared<TaskPool>(2));
+
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            auto div = window->appContainer()->add<Div>();
+            div->style()
+               ->set(position, "absolute")
+               ->set(left, 10)
+               ->set(top, 10)
+               ->set(width, 30)
+               ->set(height, 20)
+               ->set(backgroundColor, 0xFF00FF00);
+            application->step();
+
+            THEN("the tiles are stitched together") {
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                for (int y = 0; y < 48; ++y) {
+                    for (int x = 0; x < 64; ++x) {
+                        const bool inside = x >= 10 && x < 40 && y >= 10 && y < 30;
+                        REQUIRE(pixmap.getColor(x, y) == (inside ? 0xFF00FF00 : 0xFFFF0000));
+                    }
+                }
+            }
+
+            THEN("previous snapshots are left untouched") {
+                auto image = systemWindow->snapshot();
+                div->style()->set(backgroundColor, 0xFF0000FF);
+                application->step();
+
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFF00FF00);
+                REQUIRE(systemWindow->snapshot()->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFF0000FF);
+            }
+
+            THEN("frames drawn while a snapshot is held don't write into it") {
+                auto held = systemWindow->snapshot();
+                window->appContainer()->style()->set(backgroundColor, 0xFF0000FF);
+                div->style()->set(backgroundColor, 0xFFFFFF00);
+                application->step();
+
+                SkPixmap heldPixmap;
+                SkPixmap drawnPixmap;
+                REQUIRE(held->peekPixels(&heldPixmap));
+                REQUIRE(systemWindow->snapshot()->peekPixels(&drawnPixmap));
+                for (int y = 0; y < 48; ++y) {
+                    for (int x = 0; x < 64; ++x) {
+                        const bool inside = x >= 10 && x < 40 && y >= 10 && y < 30;
+                        REQUIRE(heldPixmap.getColor(x, y) == (inside ? 0xFF00FF00 : 0xFFFF0000));
+                        REQUIRE(drawnPixmap.getColor(x, y) == (inside ? 0xFFFFFF00 : 0xFF0000FF));
+                    }
+                }
+            }
+        }
+
+        WHEN("a box has a gap") {
+            auto box = window->appContainer()->add<HBox>(10);
+            auto a   = box->add<Div>();
+            auto b   = box->add<Div>();
+            for (const auto &div: {a, b}) {
+                div->style()->set(width, 20)->set(height, 20);
+            }
+            application->step();
+
+            THEN("its children are spaced by the gap") {
+                REQUIRE(b->x() - a->x() == 30);
+            }
+
+            THEN("children appended after the last one are spaced too") {
+                auto c = box->add<Div>();
+                c->style()->set(width, 20)->set(height, 20);
+                application->step();
+                REQUIRE(b->x() - a->x() == 30);
+                REQUIRE(c->x() - b->x() == 30);
+            }
+
+            THEN("the gap can be changed") {
+                box->setGap(4);
+                application->step();
+                REQUIRE(b->x() - a->x() == 24);
+            }
+        }
+
+        WHEN("a subtree is retained") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            auto panel = window->appContainer()->add<Div>();
+            panel->style()
+                 ->set(position, "absolute")
+                 ->set(left, 10)
+                 ->set(top, 10)
+                 ->set(width, 20)
+                 ->set(height, 20)
+                 ->set(retained, true);
+            auto child = panel->add<Div>();
+            child->style()
+                 ->set(width, 10)
+                 ->set(height, 10)
+                 ->set(backgroundColor, 0xFF00FF00);
+            application->step();
+
+            THEN("it is recorded once rendered") {
+                REQUIRE(panel->retainedPicture() != nullptr);
+                REQUIRE(child->retainedPicture() == nullptr);
+            }
+
+            THEN("damage outside of it keeps the recording") {
+                auto picture = panel->retainedPicture();
+                window->appContainer()->style()->set(backgroundColor, 0xFF0000FF);
+                application->step();
+                REQUIRE(panel->retainedPicture() == picture);
+
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFF00FF00);
+                REQUIRE(pixmap.getColor(40, 30) == 0xFF0000FF);
+            }
+
+            THEN("a change in the subtree records it again") {
+                auto picture = panel->retainedPicture();
+                child->style()->set(backgroundColor, 0xFFFFFF00);
+                application->step();
+                REQUIRE(panel->retainedPicture() != nullptr);
+                REQUIRE(panel->retainedPicture() != picture);
+
+                auto     image = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(image->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFFFFFF00);
+            }
+
+            THEN("adding a child records it again") {
+                panel->add<Div>()->style()->set(height, 4);
+                REQUIRE(panel->retainedPicture() == nullptr);
+            }
+
+            THEN("it is no longer recorded once not retained") {
+                panel->style()->set(retained, false);
+                application->step();
+                REQUIRE(panel->retainedPicture() == nullptr);
+            }
+        }
+
+        WHEN("a subtree is rendered in a layer") {
+            window->appContainer()->style()->set(backgroundColor, 0xFFFF0000);
+            auto panel = window->appContainer()->add<Div>();
+            panel->style()
+                 ->set(position, "absolute")
+                 ->set(left, 10)
+                 ->set(top, 10)
+                 ->set(width, 20)
+                 ->set(height, 20)
+                 ->set(backgroundColor, 0xFF00FF00)
+                 ->set(layer, true);
+            application->step();
+
+            THEN("it is rasterized once rendered") {
+                auto image = panel->layerImage();
+                REQUIRE(image != nullptr);
+                REQUIRE(image->width() == 20);
+                REQUIRE(image->height() == 20);
+
+                window->appContainer()->style()->set(backgroundColor, 0xFF0000FF);
+                application->step();
+                REQUIRE(panel->layerImage() == image);
+
+                auto     snapshot = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(snapshot->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFF00FF00);
+                REQUIRE(pixmap.getColor(40, 30) == 0xFF0000FF);
+            }
+
+            THEN("a change in the subtree rasterizes it again") {
+                auto image = panel->layerImage();
+                panel->style()->set(backgroundColor, 0xFFFFFF00);
+                application->step();
+                REQUIRE(panel->layerImage() != nullptr);
+                REQUIRE(panel->layerImage() != image);
+
+                auto     snapshot = systemWindow->snapshot();
+                SkPixmap pixmap;
+                REQUIRE(snapshot->peekPixels(&pixmap));
+                REQUIRE(pixmap.getColor(15, 15) == 0xFFFFFF00);
+            }
+
+            THEN("it is drawn as usual once evicted") {
+                LayerCache::getInstance()->clear();
+                REQUIRE(panel->layerImage() == nullptr);
+                window->invalidateRender();
+                application->step();
+                REQUIRE(panel->layerImage() != nullptr);
+            }
+        }
+
+        WHEN("the data of a container changes") {
+            unsigned int                           created = 0;
+            std::unordered_map<Div *, std::string> items{};
+
+            auto list = window->appContainer()->add<DataContainer<std::string>>(
+                std::vector<std::string>{"a", "b", "c", "d", "e"},
+                [&created, &items](const std::string &item) {
+                    ++created;
+                    auto div = std::make_shared<Div>();
+                    div->style()->set(height, 5);
+                    items[div.get()] = item;
+                    return div;
+                }
+            );
+            application->step();
+            REQUIRE(created == 5);
+
+            // Children are stored last first
+            auto order = [&list, &items]() {
+                std::vector<std::string> result{};
+                for (unsigned int i = list->childCount(); i > 0; --i) {
+                    result.push_back(items[list->at(i - 1)]);
+                }
+                return result;
+            };
+            std::unordered_map<std::string, Div *> divs{};
+            for (unsigned int i = 0; i < list->childCount(); ++i) {
+                divs[items[list->at(i)]] = list->at(i);
+            }
+
+            list->setData({"e", "a", "c", "x", "b"});
+            application->step();
+
+            THEN("only the new items get a div") {
+                REQUIRE(created == 6);
+                REQUIRE(order() == std::vector<std::string>{"e", "a", "c", "x", "b"});
+                for (const auto &item: {"a", "b", "c", "e"}) {
+                    REQUIRE(list->childIndex(divs[item]) >= 0);
+                }
+            }
+
+            THEN("the layout follows the new order") {
+                int y = -1;
+                for (unsigned int i = list->childCount(); i > 0; --i) {
+                    REQUIRE(list->at(i - 1)->y() > y);
+                    y = list->at(i - 1)->y();
+                }
+            }
+
+            THEN("items can be keyed by something else than their value") {
+                auto keyed = window->appContainer()->add<DataContainer<std::string, char>>(
+                    std::vector<std::string>{"a1", "b1"},
+                    [](const std::string &) { return std::make_shared<Div>(); },
+                    [](const std::string &item) { return item[0]; },
+                    [](Div &, const std::string &) { return true; }
+                );
+                application->step();
+                const Div *a = keyed->at(1);
+                const Div *b = keyed->at(0);
+
+                keyed->setData({"b2", "a2"});
+                REQUIRE(keyed->at(1) == b);
+                REQUIRE(keyed->at(0) == a);
+            }
+
+            THEN("items that can't be ordered get new divs on every change") {
+                unsigned int unorderedCreated = 0;
+                auto         unordered        = window->appContainer()->add<DataContainer<UnorderedItem>>(
+                    std::vector<UnorderedItem>{{1}, {2}},
+                    [&unorderedCreated](const UnorderedItem &) {
+                        ++unorderedCreated;
+                        return std::make_shared<Div>();
+                    }
+                );
+                application->step();
+                REQUIRE(unorderedCreated == 2);
+
+                unordered->setData({{2}, {3}, {1}});
+                application->step();
+                REQUIRE(unorderedCreated == 5);
+                REQUIRE(unordered->childCount() == 3);
+            }
+        }
+
+        WHEN("a long list is virtualized") {
+            unsigned int                          created = 0;
+            std::unordered_map<Div *, std::size_t> bound{};
+
+            auto list = std::make_shared<VirtualDataContainer<int>>(
+                std::vector<int>(10000, 0),
+                [&created]() {
+                    ++created;
+                    return std::make_shared<Div>();
+                },
+                [&bound](Div &div, const int &, std::size_t index) {
+                    bound[&div] = index;
+                },
+                10
+            );
+            auto scroller = window->appContainer()->add<Scroller>(list);
+            scroller->style()
+                    ->set(widthPercent, 1.0f)
+                    ->set(heightPercent, 1.0f);
+            application->step();
+            application->step();
+
+            THEN("only the visible items are instantiated") {
+                REQUIRE(list->firstIndex() == 0);
+                REQUIRE(list->instantiatedCount() > list->overscan());
+                REQUIRE(list->instantiatedCount() <= 48 / 10 + 1 + list->overscan());
+                REQUIRE(created == list->instantiatedCount());
+            }
+
+            THEN("the scroll bars see the whole list") {
+                REQUIRE(list->extents().total() == 100000);
+                REQUIRE(scroller->viewport()->contentHeight() >= 100000);
+            }
+
+            THEN("scrolling recycles the items") {
+                const std::size_t count = list->instantiatedCount();
+                scroller->viewport()->setScrollY(-5000);
+                application->step();
+
+                REQUIRE(list->firstIndex() == 500 - list->overscan());
+                REQUIRE(list->instantiatedCount() == count + list->overscan());
+                REQUIRE(list->itemDiv(495) == nullptr);
+                REQUIRE(list->itemDiv(500) != nullptr);
+                REQUIRE(bound[list->itemDiv(500)] == 500);
+                REQUIRE(created == list->instantiatedCount());
+
+                scroller->viewport()->setScrollY(0);
+                application->step();
+                REQUIRE(list->firstIndex() == 0);
+                REQUIRE(list->poolSize() == list->overscan());
+                REQUIRE(created == count + list->overscan());
+            }
+        }
+
+        WHEN("the main loop has a frame limit") {
+            application->setFrameLimit(3);
+
+            THEN("it renders that many frames") {
+                application->mainloop();
+                REQUIRE(systemWindow->frames() == 3);
+            }
+        }
+
+        application->close(window);
+    }
+
+    application->shutdown();
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include <memory>
+#include "catch2/catch.hpp"
+#include <psychic-ui/style/AncestorFilter.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include <psychic-ui/style/StyleSelector.hpp>
+#include <psychic-ui/Div.hpp>
+
+using namespace psychic_ui;
+
+TEST_CASE("Ancestor filter", "[style]") {
+    auto root = std::make_shared<Div>();
+    root->setId("root");
+    root->addClassName("panel");
+    auto child = root->add<Div>();
+    child->addClassName("section");
+    auto leaf = child->add<Div>();
+
+    AncestorFilter filter{};
+
+    SECTION("contains the keys of the pushed ancestors") {
+        filter.push(root.get());
+        REQUIRE(filter.mayContain(AncestorFilter::tagKey("div")));
+        REQUIRE(filter.mayContain(AncestorFilter::idKey("root")));
+        REQUIRE(filter.mayContain(AncestorFilter::idKey(root->internalId())));
+        REQUIRE(filter.mayContain(AncestorFilter::classKey("panel")));
+        REQUIRE(!filter.mayContain(AncestorFilter::classKey("section")));
+    }
+
+    SECTION("removes the keys of popped ancestors") {
+        filter.push(root.get());
+        filter.push(child.get());
+        REQUIRE(filter.mayContain(AncestorFilter::classKey("section")));
+        filter.pop();
+        REQUIRE(!filter.mayContain(AncestorFilter::classKey("section")));
+        REQUIRE(filter.mayContain(AncestorFilter::classKey("panel")));
+        filter.pop();
+        REQUIRE(!filter.mayContain(AncestorFilter::tagKey("div")));
+    }
+
+    SECTION("differentiates the kind of keys") {
+        filter.push(root.get());
+        REQUIRE(!filter.mayContain(AncestorFilter::tagKey("panel")));
+        REQUIRE(!filter.mayContain(AncestorFilter::idKey("panel")));
+    }
+
+    SECTION("can be filled from a div's ancestors") {
+        filter.pushAncestors(leaf.get());
+        REQUIRE(filter.mayContain(AncestorFilter::classKey("panel")));
+        REQUIRE(filter.mayContain(AncestorFilter::classKey("section")));
+    }
+
+    SECTION("rejects selectors requiring absent ancestors") {
+        filter.pushAncestors(leaf.get());
+        REQUIRE(filter.mayContainAll(StyleSelector::fromSelector(".panel .section div")->ancestorKeys()));
+        REQUIRE(filter.mayContainAll(StyleSelector::fromSelector("#root > div")->ancestorKeys()));
+        REQUIRE(!filter.mayContainAll(StyleSelector::fromSelector(".toolbar div")->ancestorKeys()));
+        REQUIRE(!filter.mayContainAll(StyleSelector::fromSelector("#other .section div")->ancestorKeys()));
+    }
+
+    SECTION("gives the same styles as matching without it") {
+        auto styleManager = std::make_shared<StyleManager>();
+        styleManager->style(".panel .section div")->set(color, 0xFFFF0000);
+        styleManager->style(".toolbar div")->set(color, 0xFF00FF00);
+        styleManager->style("#root div")->set(opacity, 0.5f);
+        root->setStyleManager(styleManager);
+
+        root->updateStyleRecursive();
+        REQUIRE(leaf->computedStyle()->get(color) == 0xFFFF0000);
+        REQUIRE(leaf->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(*leaf->computedStyle() == *styleManager->computeStyle(leaf.get()));
+    }
+}
@@ -0,0 +1,189 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "catch2/catch.hpp"
+#include <psychic-ui/style/CompiledStyleSheet.hpp>
+#include <psychic-ui/style/StyleManager.hpp>
+#include <psychic-ui/style/StyleSheet.hpp>
+#include <psychic-ui/utils/MappedFile.hpp>
+#include <psychic-ui/Div.hpp>
+
+using namespace psychic_ui;
+
+namespace {
+    void declareRules(StyleManager *manager) {
+        manager->style("*")->set(fontFamily, "Ubuntu Regular")->set(fontSize, 12.0f);
+        manager->style(".panel")->set(padding, 4.0f)->set(flexDirection, "row");
+        manager->style(".panel > .item")->set(color, 0xFFFF0000)->set(cursor, 2);
+        manager->style("div.panel .item:hover")->set(color, 0xFF00FF00);
+        manager->style("#special")->set(visible, false);
+        // Equal weights in the same index bucket, the last one declared wins
+        manager->style(".item.second")->set(backgroundColor, 0xFFFFFF00);
+        manager->style(".item.first")->set(backgroundColor, 0xFF0000FF);
+    }
+
+    /**
+     * Root first, then its children
+     */
+    std::vector<std::shared_ptr<Div>> createTree(const std::shared_ptr<StyleManager> &manager) {
+        auto root = std::make_shared<Div>();
+        root->setStyleManager(manager);
+        root->addClassName("panel");
+        auto item = root->add<Div>();
+        item->addClassName("item");
+        item->addClassName("first");
+        item->addClassName("second");
+        auto hovered = root->add<Div>();
+        hovered->addClassName("item");
+        hovered->setMouseOver(true);
+        auto special = root->add<Div>();
+        special->setId("special");
+        root->updateStyleRecursive();
+        return {root, item, hovered, special};
+    }
+
+    class CountingStyleSheet : public StyleSheet {
+    public:
+        static int           loads;
+        static std::uint32_t version;
+
+        void load(StyleManager *manager) override {
+            ++loads;
+            declareRules(manager);
+        }
+
+        std::uint32_t rulesVersion() const override {
+            return version;
+        }
+    };
+
+    int           CountingStyleSheet::loads   = 0;
+    std::uint32_t CountingStyleSheet::version = 0;
+}
+
+TEST_CASE("Compiled style sheets", "[style]") {
+    auto authored = std::make_shared<StyleManager>();
+    declareRules(authored.get());
+    const std::string compiled = CompiledStyleSheet::compile(authored.get(), "rules");
+
+    auto loaded = std::make_shared<StyleManager>();
+
+    SECTION("compute the same styles as the authored rules") {
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), compiled.data(), compiled.size(), "rules"));
+        auto authoredTree = createTree(authored);
+        auto loadedTree   = createTree(loaded);
+        for (std::size_t i = 0; i < authoredTree.size(); ++i) {
+            REQUIRE(*loadedTree[i]->computedStyle() == *authoredTree[i]->computedStyle());
+        }
+
+        REQUIRE(loadedTree[1]->computedStyle()->get(color) == 0xFFFF0000);
+        REQUIRE(loadedTree[1]->computedStyle()->get(backgroundColor) == 0xFF0000FF);
+        REQUIRE(loadedTree[1]->computedStyle()->get(fontFamily) == "Ubuntu Regular");
+        REQUIRE(loadedTree[2]->computedStyle()->get(color) == 0xFF00FF00);
+        REQUIRE(!loadedTree[3]->computedStyle()->get(visible, true));
+    }
+
+    SECTION("keep the universal base rule") {
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), compiled.data(), compiled.size(), "rules"));
+        auto loadedTree = createTree(loaded);
+        // The root only matches "*", which is not in the declaration indexes
+        REQUIRE(loadedTree[0]->computedStyle()->get(fontFamily) == "Ubuntu Regular");
+        REQUIRE(loadedTree[0]->computedStyle()->get(fontSize) == 12.0f);
+        REQUIRE(loadedTree[3]->computedStyle()->get(fontSize) == 12.0f);
+    }
+
+    SECTION("set their values onto existing declarations") {
+        loaded->style(".panel")->set(margin, 2.0f)->set(padding, 8.0f);
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), compiled.data(), compiled.size(), "rules"));
+        REQUIRE(loaded->style(".panel")->get(margin) == 2.0f);
+        REQUIRE(loaded->style(".panel")->get(padding) == 4.0f);
+    }
+
+    SECTION("reject data compiled with another key") {
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), compiled.data(), compiled.size(), "other"));
+        REQUIRE(!loaded->style(".panel")->has(padding));
+    }
+
+    SECTION("reject data compiled with another stamp") {
+        const std::string stamped = CompiledStyleSheet::compile(authored.get(), "rules", 7);
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), stamped.data(), stamped.size(), "rules"));
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), stamped.data(), stamped.size(), "rules", 8));
+        REQUIRE(!loaded->style(".panel")->has(padding));
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), stamped.data(), stamped.size(), "rules", 7));
+    }
+
+    SECTION("reject truncated data without declaring anything") {
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), compiled.data(), 3, "rules"));
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), nullptr, 0, "rules"));
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), compiled.data(), compiled.size() - 1, "rules"));
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), compiled.data(), compiled.size() / 2, "rules"));
+        REQUIRE(!loaded->style(".panel")->has(padding));
+    }
+
+    SECTION("are written to and mapped from a file") {
+        const std::string path = "compiled_style_sheet_tests.psys";
+        REQUIRE(CompiledStyleSheet::save(compiled, path));
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), path, "rules"));
+        REQUIRE(loaded->style(".panel")->get(padding) == 4.0f);
+        std::remove(path.c_str());
+        REQUIRE(!CompiledStyleSheet::load(loaded.get(), path, "rules"));
+    }
+
+    SECTION("replace their file without changing the data already mapped") {
+        const std::string path = "compiled_style_sheet_tests.psys";
+        REQUIRE(CompiledStyleSheet::save(compiled, path));
+        MappedFile mapped{path};
+        REQUIRE(mapped.valid());
+
+        const std::string other = CompiledStyleSheet::compile(authored.get(), "other");
+        REQUIRE(CompiledStyleSheet::save(other, path));
+        REQUIRE(std::string(mapped.data(), mapped.size()) == compiled);
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), mapped.data(), mapped.size(), "rules"));
+        REQUIRE(CompiledStyleSheet::load(loaded.get(), path, "other"));
+
+        REQUIRE(!MappedFile{path + ".tmp"}.valid());
+        std::remove(path.c_str());
+    }
+
+    SECTION("are compiled by the first load of a style sheet") {
+        const std::string path = "compiled_style_sheet_tests.psys";
+        std::remove(path.c_str());
+        CountingStyleSheet::loads = 0;
+
+        loaded->loadStyleSheet<CountingStyleSheet>(path);
+        REQUIRE(CountingStyleSheet::loads == 1);
+        REQUIRE(loaded->style(".panel")->get(padding) == 4.0f);
+
+        auto again = std::make_shared<StyleManager>();
+        again->loadStyleSheet<CountingStyleSheet>(path);
+        REQUIRE(CountingStyleSheet::loads == 1);
+        REQUIRE(again->style(".panel > .item")->get(color) == 0xFFFF0000);
+        REQUIRE(createTree(again)[0]->computedStyle()->get(fontFamily) == "Ubuntu Regular");
+        std::remove(path.c_str());
+    }
+
+    SECTION("are compiled again when the rules version changes") {
+        const std::string path = "compiled_style_sheet_tests.psys";
+        std::remove(path.c_str());
+        CountingStyleSheet::loads   = 0;
+        CountingStyleSheet::version = 1;
+
+        loaded->loadStyleSheet<CountingStyleSheet>(path);
+        REQUIRE(CountingStyleSheet::loads == 1);
+
+        CountingStyleSheet::version = 2;
+        auto again = std::make_shared<StyleManager>();
+        again->loadStyleSheet<CountingStyleSheet>(path);
+        REQUIRE(CountingStyleSheet::loads == 2);
+        REQUIRE(again->style(".panel")->get(padding) == 4.0f);
+
+        auto last = std::make_shared<StyleManager>();
+        last->loadStyleSheet<CountingStyleSheet>(path);
+        REQUIRE(CountingStyleSheet::loads == 2);
+
+        CountingStyleSheet::version = 0;
+        std::remove(path.c_str());
+    }
+}
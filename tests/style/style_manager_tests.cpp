@@ -4,6 +4,7 @@
 #include <psychic-ui/style/Style.hpp>
 #include <psychic-ui/Div.hpp>
 #include <psychic-ui/components/Button.hpp>
+#include <psychic-ui/utils/TaskPool.hpp>
 
 using namespace psychic_ui;
 
@@ -605,4 +606,450 @@ TEST_CASE("Regressions") {
         REQUIRE(styleManager->computeStyle(btn.get())->get(color) == 0xFFFF0000);
     }
 
+    SECTION("Should match declarations added after a computation") {
+        auto div = std::make_shared<Div>();
+        div->setStyleManager(styleManager);
+        div->setId("id");
+        div->setClassNames({"class"});
+
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) != 0xFFFF0000);
+
+        styleManager->style("#id")
+                    ->set(color, 0xFFFF0000);
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) == 0xFFFF0000);
+
+        styleManager->style("#id.class")
+                    ->set(color, 0xFF0000FF);
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) == 0xFF0000FF);
+    }
+
+    SECTION("Declarations of the same weight apply in declaration order") {
+        styleManager->style("div")
+                    ->set(color, 0xFFFF0000);
+        styleManager->style(".first")
+                    ->set(color, 0xFF00FF00);
+        styleManager->style(".second")
+                    ->set(color, 0xFF0000FF);
+
+        auto div = std::make_shared<Div>();
+        div->setStyleManager(styleManager);
+        div->setClassNames({"second", "first"});
+
+        // Same weight for the tag and both classes, the last declared wins whatever the index bucket
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) == 0xFF0000FF);
+
+        styleManager->style("div")
+                    ->set(color, 0xFFFF00FF);
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) == 0xFF0000FF);
+    }
+
+    SECTION("Should match selectors without id, class or tag") {
+        styleManager->style(":hover")
+                    ->set(color, 0xFFFF0000);
+
+        auto div = std::make_shared<Div>();
+        div->setStyleManager(styleManager);
+
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) != 0xFFFF0000);
+
+        div->setMouseOver(true);
+        REQUIRE(styleManager->computeStyle(div.get())->get(color) == 0xFFFF0000);
+    }
+
+}
+
+TEST_CASE("Style sharing between siblings", "[style]") {
+    auto styleManager = std::make_shared<StyleManager>();
+    styleManager->style(".item")->set(color, 0xFFFF0000);
+    styleManager->style(".item:hover")->set(color, 0xFF00FF00);
+    styleManager->style(".item:last-child")->set(backgroundColor, 0xFF0000FF);
+
+    auto parent = std::make_shared<Div>();
+    parent->setStyleManager(styleManager);
+    auto a = parent->add<Div>();
+    auto b = parent->add<Div>();
+    auto c = parent->add<Div>();
+    auto d = parent->add<Div>();
+    for (const auto &item: {a, b, c, d}) {
+        item->addClassName("item");
+    }
+
+    SECTION("Siblings matching the same declarations share their computed style") {
+        parent->updateStyleRecursive();
+        REQUIRE(a->computedStyle() == b->computedStyle());
+        REQUIRE(a->computedStyle() == c->computedStyle());
+        REQUIRE(a->computedStyle()->get(color) == 0xFFFF0000);
+    }
+
+    SECTION("Structural pseudo classes prevent sharing") {
+        parent->updateStyleRecursive();
+        REQUIRE(a->computedStyle() != d->computedStyle());
+        REQUIRE(d->computedStyle()->get(backgroundColor) == 0xFF0000FF);
+        REQUIRE(!a->computedStyle()->has(backgroundColor));
+    }
+
+    SECTION("Dynamic pseudo classes prevent sharing") {
+        b->setMouseOver(true);
+        parent->updateStyleRecursive();
+        REQUIRE(a->computedStyle() != b->computedStyle());
+        REQUIRE(b->computedStyle()->get(color) == 0xFF00FF00);
+        REQUIRE(a->computedStyle() == c->computedStyle());
+    }
+
+    SECTION("Different classes prevent sharing") {
+        b->addClassName("other");
+        parent->updateStyleRecursive();
+        REQUIRE(a->computedStyle() != b->computedStyle());
+    }
+
+    SECTION("Inline styles prevent sharing") {
+        b->style()->set(opacity, 0.5f);
+        parent->updateStyleRecursive();
+        REQUIRE(a->computedStyle() != b->computedStyle());
+        REQUIRE(b->computedStyle()->get(opacity) == 0.5f);
+    }
+
+    SECTION("Id declarations prevent sharing") {
+        b->setId("special");
+        styleManager->style("#special")->set(color, 0xFFFFFFFF);
+        parent->updateStyleRecursive();
+        REQUIRE(a->computedStyle() != b->computedStyle());
+        REQUIRE(b->computedStyle()->get(color) == 0xFFFFFFFF);
+    }
+
+    SECTION("A shared style is computed again for siblings that changed") {
+        styleManager->style(".other")->set(opacity, 0.5f);
+        parent->updateStyleRecursive();
+        c->addClassName("other");
+        parent->updateInvalidStyles();
+        REQUIRE(a->computedStyle() == b->computedStyle());
+        REQUIRE(a->computedStyle() != c->computedStyle());
+        REQUIRE(c->computedStyle()->get(color) == 0xFFFF0000);
+        REQUIRE(c->computedStyle()->get(opacity) == 0.5f);
+    }
+}
+
+TEST_CASE("Inherited values are shared", "[style]") {
+    auto styleManager = std::make_shared<StyleManager>();
+    styleManager->style(".root")->set(color, 0xFFFF0000)->set(fontSize, 20.0f);
+    styleManager->style(".a")->set(opacity, 0.5f);
+    styleManager->style(".b")->set(backgroundColor, 0xFF0000FF);
+    styleManager->style(".override")->set(color, 0xFF00FF00);
+
+    auto root = std::make_shared<Div>();
+    root->setStyleManager(styleManager);
+    root->addClassName("root");
+    auto panel = root->add<Div>();
+    auto a     = panel->add<Div>();
+    a->addClassName("a");
+    auto b = panel->add<Div>();
+    b->addClassName("b");
+    auto c = panel->add<Div>();
+    c->addClassName("override");
+    auto leaf  = a->add<Div>();
+    auto cLeaf = c->add<Div>();
+
+    SECTION("Divs that don't override inherited values share the block of their parent") {
+        root->updateStyleRecursive();
+        REQUIRE(!root->computedStyle()->inherited());
+        REQUIRE(panel->computedStyle()->inherited());
+        REQUIRE(a->computedStyle()->inherited() == panel->computedStyle()->inherited());
+        REQUIRE(b->computedStyle()->inherited() == panel->computedStyle()->inherited());
+        REQUIRE(leaf->computedStyle()->inherited() == panel->computedStyle()->inherited());
+        REQUIRE(leaf->computedStyle()->get(color) == 0xFFFF0000);
+        REQUIRE(leaf->computedStyle()->get(fontSize) == 20.0f);
+        REQUIRE(a->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(b->computedStyle()->get(backgroundColor) == 0xFF0000FF);
+    }
+
+    SECTION("Overridden values start a new block") {
+        root->updateStyleRecursive();
+        REQUIRE(c->computedStyle()->get(color) == 0xFF00FF00);
+        REQUIRE(cLeaf->computedStyle()->inherited() != panel->computedStyle()->inherited());
+        REQUIRE(cLeaf->computedStyle()->get(color) == 0xFF00FF00);
+        REQUIRE(cLeaf->computedStyle()->get(fontSize) == 20.0f);
+    }
+
+    SECTION("Inherited values take precedence over universal declarations") {
+        styleManager->style("*")->set(color, 0xFFFFFFFF)->set(fontSize, 10.0f);
+        root->updateStyleRecursive();
+        REQUIRE(root->computedStyle()->get(color) == 0xFFFF0000);
+        REQUIRE(leaf->computedStyle()->get(color) == 0xFFFF0000);
+        REQUIRE(leaf->computedStyle()->get(fontSize) == 20.0f);
+        REQUIRE(leaf->computedStyle()->inherited() == panel->computedStyle()->inherited());
+    }
+
+    SECTION("Changing an inherited value restyles the divs sharing it") {
+        root->updateStyleRecursive();
+        root->style()->set(color, 0xFF00FFFF);
+        root->updateInvalidStyles();
+        REQUIRE(a->computedStyle()->get(color) == 0xFF00FFFF);
+        REQUIRE(leaf->computedStyle()->get(color) == 0xFF00FFFF);
+        REQUIRE(cLeaf->computedStyle()->get(color) == 0xFF00FF00);
+    }
+
+    SECTION("Copies flatten inherited values") {
+        root->updateStyleRecursive();
+        Style copy{leaf->computedStyle()};
+        REQUIRE(!copy.inherited());
+        REQUIRE(copy.get(color) == 0xFFFF0000);
+        REQUIRE(copy == *leaf->computedStyle());
+    }
+}
+
+TEST_CASE("Targeted style invalidation", "[style]") {
+    auto styleManager = std::make_shared<StyleManager>();
+    styleManager->style(".item")->set(color, 0xFFFF0000);
+
+    auto parent = std::make_shared<Div>();
+    parent->setStyleManager(styleManager);
+    auto item  = parent->add<Div>();
+    auto child = item->add<Div>();
+    item->addClassName("item");
+
+    SECTION("State changes without matching declarations don't restyle") {
+        parent->updateStyleRecursive();
+        const Style *itemStyle  = item->computedStyle();
+        const Style *childStyle = child->computedStyle();
+        item->setMouseOver(true);
+        item->addClassName("unused");
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle() == itemStyle);
+        REQUIRE(child->computedStyle() == childStyle);
+    }
+
+    SECTION("Pseudo classes of the subject only restyle the div") {
+        styleManager->style(".item:hover")->set(opacity, 0.5f);
+        parent->updateStyleRecursive();
+        const Style *childStyle = child->computedStyle();
+        item->setMouseOver(true);
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(child->computedStyle() == childStyle);
+    }
+
+    SECTION("Pseudo classes of an ancestor restyle the subtree") {
+        styleManager->style(".item:hover div")->set(backgroundColor, 0xFF00FF00);
+        parent->updateStyleRecursive();
+        REQUIRE(!child->computedStyle()->has(backgroundColor));
+        item->setMouseOver(true);
+        parent->updateInvalidStyles();
+        REQUIRE(child->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+    }
+
+    SECTION("Classes of an ancestor restyle the subtree") {
+        styleManager->style(".open div")->set(backgroundColor, 0xFF00FF00);
+        parent->updateStyleRecursive();
+        item->addClassName("open");
+        parent->updateInvalidStyles();
+        REQUIRE(child->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+        item->removeClassName("open");
+        parent->updateInvalidStyles();
+        REQUIRE(!child->computedStyle()->has(backgroundColor));
+    }
+
+    SECTION("Inherited values changed on the div are propagated to the children") {
+        styleManager->style(".item:hover")->set(color, 0xFF0000FF);
+        parent->updateStyleRecursive();
+        REQUIRE(child->computedStyle()->get(color) == 0xFFFF0000);
+        item->setMouseOver(true);
+        parent->updateInvalidStyles();
+        REQUIRE(child->computedStyle()->get(color) == 0xFF0000FF);
+    }
+
+    SECTION("Inline styles only restyle the div and the children inheriting from it") {
+        parent->updateStyleRecursive();
+        const Style *childStyle = child->computedStyle();
+        item->style()->set(opacity, 0.5f);
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(child->computedStyle() == childStyle);
+        item->style()->set(color, 0xFF0000FF);
+        parent->updateInvalidStyles();
+        REQUIRE(child->computedStyle()->get(color) == 0xFF0000FF);
+    }
+
+    SECTION("Inserting or removing children restyles the siblings that stop being first or last") {
+        styleManager->style(".item:first-child")->set(opacity, 0.5f);
+        styleManager->style(".item:last-child")->set(backgroundColor, 0xFF00FF00);
+        styleManager->style(".item:empty")->set(borderColor, 0xFF0000FF);
+        auto other = parent->add<Div>();
+        other->addClassName("item");
+        parent->updateStyleRecursive();
+        REQUIRE(item->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(other->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+
+        auto inserted = std::make_shared<Div>();
+        inserted->addClassName("item");
+        parent->add(0, inserted);
+        parent->updateInvalidStyles();
+        REQUIRE(inserted->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(!item->computedStyle()->has(opacity));
+
+        parent->remove(other);
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+
+        REQUIRE(!item->computedStyle()->has(borderColor));
+        item->remove(child);
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle()->get(borderColor) == 0xFF0000FF);
+    }
+
+    SECTION("Moving children restyles the siblings that become or stop being first or last") {
+        styleManager->style(".item:first-child")->set(opacity, 0.5f);
+        styleManager->style(".item:last-child")->set(backgroundColor, 0xFF00FF00);
+        auto middle = parent->add<Div>();
+        middle->addClassName("item");
+        auto last = parent->add<Div>();
+        last->addClassName("item");
+        parent->updateStyleRecursive();
+        REQUIRE(item->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(last->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+
+        // The last child becomes the first one
+        parent->move(last, 0);
+        parent->updateInvalidStyles();
+        REQUIRE(last->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(!last->computedStyle()->has(backgroundColor));
+        REQUIRE(!item->computedStyle()->has(opacity));
+        REQUIRE(middle->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+
+        // The first child goes to the middle, the ends swap their roles
+        parent->move(last, 1);
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(!last->computedStyle()->has(opacity));
+        REQUIRE(!last->computedStyle()->has(backgroundColor));
+        REQUIRE(middle->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+
+        // A child moving within the middle leaves the ends alone
+        auto extra = std::make_shared<Div>();
+        extra->addClassName("item");
+        parent->add(2, extra);
+        parent->updateInvalidStyles();
+        parent->move(extra, 1);
+        parent->updateInvalidStyles();
+        REQUIRE(item->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(middle->computedStyle()->get(backgroundColor) == 0xFF00FF00);
+        REQUIRE(!extra->computedStyle()->has(opacity));
+        REQUIRE(!extra->computedStyle()->has(backgroundColor));
+    }
+}
+
+TEST_CASE("Owned declarations", "[style]") {
+    auto styleManager = std::make_shared<StyleManager>();
+    styleManager->style(".shared")->set(opacity, 0.5f);
+
+    auto root  = std::make_shared<Div>();
+    root->setStyleManager(styleManager);
+    auto owner = root->add<Div>();
+    auto other = root->add<Div>();
+    other->addClassName("owned");
+    other->addClassName("shared");
+
+    owner->ownedStyle(".owned")->set(color, 0xFFFF0000);
+    owner->ownedStyle(".shared")->set(borderColor, 0xFF00FF00);
+
+    SECTION("apply like any other declaration") {
+        root->updateStyleRecursive();
+        REQUIRE(other->computedStyle()->get(color) == 0xFFFF0000);
+    }
+
+    SECTION("are retired with their owner") {
+        root->updateStyleRecursive();
+        styleManager->setValid();
+        root->remove(owner);
+        owner.reset();
+        // Divs styled by the retired declarations have to be restyled
+        REQUIRE(!styleManager->valid());
+        root->updateStyleRecursive();
+        REQUIRE(other->computedStyle()->get(color) != 0xFFFF0000);
+        REQUIRE(!styleManager->style(".owned")->has(color));
+    }
+
+    SECTION("don't take existing declarations") {
+        root->remove(owner);
+        owner.reset();
+        root->updateStyleRecursive();
+        REQUIRE(other->computedStyle()->get(opacity) == 0.5f);
+        REQUIRE(other->computedStyle()->get(borderColor) == 0xFF00FF00);
+    }
+}
+
+namespace {
+    /**
+     * Change Div::parallelStyleThreshold for a scope,
+     * restored even when a failing assertion leaves the scope early
+     */
+    struct ParallelStyleThreshold {
+        const unsigned int previous;
+
+        explicit ParallelStyleThreshold(unsigned int threshold) :
+            previous(Div::parallelStyleThreshold) {
+            Div::parallelStyleThreshold = threshold;
+        }
+
+        ~ParallelStyleThreshold() {
+            Div::parallelStyleThreshold = previous;
+        }
+    };
+}
+
+TEST_CASE("Parallel restyle", "[style]") {
+    auto styleManager = std::make_shared<StyleManager>();
+    styleManager->style("*")->set(color, 0xFF000000);
+    styleManager->style(".panel")->set(padding, 4.0f);
+    styleManager->style(".panel .cell")->set(backgroundColor, 0xFFFF0000);
+    styleManager->style(".row > .cell:last-child")->set(opacity, 0.5f);
+    styleManager->style(".odd")->set(color, 0xFF00FF00);
+
+    auto createTree = [&styleManager](std::vector<std::shared_ptr<Div>> &divs) {
+        auto root = std::make_shared<Div>();
+        root->setStyleManager(styleManager);
+        divs.push_back(root);
+        for (unsigned int p = 0; p < 4; ++p) {
+            auto panel = root->add<Div>();
+            panel->addClassName("panel");
+            divs.push_back(panel);
+            for (unsigned int r = 0; r < 8; ++r) {
+                auto row = panel->add<Div>();
+                row->addClassName("row");
+                if (r % 2 == 1) {
+                    row->addClassName("odd");
+                }
+                divs.push_back(row);
+                for (unsigned int c = 0; c < 4; ++c) {
+                    auto cell = row->add<Div>();
+                    cell->addClassName("cell");
+                    divs.push_back(cell);
+                }
+            }
+        }
+        return root;
+    };
+
+    std::vector<std::shared_ptr<Div>> sequentialDivs{};
+    std::vector<std::shared_ptr<Div>> parallelDivs{};
+    auto                              sequential = createTree(sequentialDivs);
+    auto                              parallel   = createTree(parallelDivs);
+    REQUIRE(parallel->subtreeSize() == parallelDivs.size());
+
+    // Small threshold so that every panel and row runs as a task
+    ParallelStyleThreshold threshold{4};
+    TaskPool               pool{2};
+
+    auto compare = [&]() {
+        sequential->updateStyleRecursive();
+        parallel->updateStyleRecursive(pool);
+        for (std::size_t i = 0; i < sequentialDivs.size(); ++i) {
+            REQUIRE(*parallelDivs[i]->computedStyle() == *sequentialDivs[i]->computedStyle());
+        }
+    };
+
+    compare();
+    REQUIRE(parallelDivs.back()->computedStyle()->get(backgroundColor) == 0xFFFF0000);
+
+    styleManager->style(".panel")->set(color, 0xFF0000FF);
+    compare();
 }
@@ -196,3 +196,199 @@ TEST_CASE( "Styles can overlay inheritable values", "[style]" ) {
     }
 
 }
+
+TEST_CASE( "Styles keep their values whatever the order they are set in", "[style]" ) {
+    auto style = std::make_unique<Style>();
+
+    style->set(paddingTop, 3.0f);
+    style->set(flex, 1.0f);
+    style->set(borderRadiusBottomRight, 4.0f);
+    style->set(width, 2.0f);
+
+    REQUIRE(style->get(flex) == 1.0f);
+    REQUIRE(style->get(width) == 2.0f);
+    REQUIRE(style->get(paddingTop) == 3.0f);
+    REQUIRE(style->get(borderRadiusBottomRight) == 4.0f);
+    REQUIRE(!style->has(height));
+
+    SECTION("when overlaying in between existing values") {
+        auto overlay = std::make_unique<Style>();
+        overlay->set(height, 5.0f);
+        overlay->set(width, 6.0f);
+        style->overlay(overlay.get());
+        REQUIRE(style->get(flex) == 1.0f);
+        REQUIRE(style->get(width) == 6.0f);
+        REQUIRE(style->get(height) == 5.0f);
+        REQUIRE(style->get(paddingTop) == 3.0f);
+        REQUIRE(style->get(borderRadiusBottomRight) == 4.0f);
+    }
+}
+
+TEST_CASE( "Styles can be compared", "[style]" ) {
+    auto a = std::make_unique<Style>();
+    auto b = std::make_unique<Style>();
+
+    SECTION("with the same values set in a different order") {
+        a->set(color, 0xFFFF0000);
+        a->set(fontFamily, "Arial");
+        a->set(opacity, 0.5f);
+        b->set(opacity, 0.5f);
+        b->set(fontFamily, "Arial");
+        b->set(color, 0xFFFF0000);
+        REQUIRE(*a == *b);
+        b->set(fontFamily, "Times");
+        REQUIRE(*a != *b);
+    }
+
+    SECTION("with auto values") {
+        a->set(width, Style::Auto);
+        b->set(width, Style::Auto);
+        REQUIRE(*a == *b);
+    }
+
+    SECTION("without notifying unchanged values") {
+        int  changes = 0;
+        auto style   = std::make_unique<Style>([&changes]() { ++changes; });
+        style->set(fontFamily, "Arial");
+        style->set(fontFamily, "Arial");
+        style->set(width, Style::Auto);
+        style->set(width, Style::Auto);
+        REQUIRE(changes == 2);
+    }
+}
+
+TEST_CASE( "Style changes are classified", "[style]" ) {
+    auto previous = std::make_unique<Style>();
+    auto current  = std::make_unique<Style>();
+    auto div      = std::make_shared<Div>();
+
+    previous->set(color, 0xFFFF0000);
+    previous->set(backgroundColor, 0xFFFF0000);
+    previous->set(width, 100.0f);
+    current->overlay(previous.get());
+
+    SECTION("without changes") {
+        auto changes = current->diff(*previous);
+        REQUIRE(changes.empty());
+        REQUIRE(!changes.affectsLayout());
+        REQUIRE(!changes.affectsInheritance(div->inheritableValues()));
+    }
+
+    SECTION("with paint only changes") {
+        current->set(backgroundColor, 0xFF00FF00);
+        current->set(opacity, 0.5f);
+        auto changes = current->diff(*previous);
+        REQUIRE(!changes.empty());
+        REQUIRE(!changes.affectsLayout());
+        REQUIRE(!changes.affectsInheritance(div->inheritableValues()));
+    }
+
+    SECTION("with layout changes") {
+        current->set(width, 200.0f);
+        auto changes = current->diff(*previous);
+        REQUIRE(changes.affectsLayout());
+        REQUIRE(!changes.affectsInheritance(div->inheritableValues()));
+    }
+
+    SECTION("with removed layout values") {
+        previous->set(paddingLeft, 10.0f);
+        auto changes = current->diff(*previous);
+        REQUIRE(changes.affectsLayout());
+    }
+
+    SECTION("with inherited changes") {
+        current->set(color, 0xFF00FF00);
+        auto changes = current->diff(*previous);
+        REQUIRE(!changes.affectsLayout());
+        REQUIRE(changes.affectsInheritance(div->inheritableValues()));
+    }
+
+    SECTION("with auto values") {
+        previous->set(height, Style::Auto);
+        current->set(height, Style::Auto);
+        REQUIRE(current->diff(*previous).empty());
+    }
+}
+
+TEST_CASE( "Computed styles are resolved to typed values", "[style]" ) {
+    auto          style = std::make_unique<Style>();
+    ResolvedStyle resolved{};
+
+    SECTION("with the defaults of an empty style") {
+        ResolvedStyle defaults{};
+        resolved.resolve(*style);
+        REQUIRE(resolved.overflow == defaults.overflow);
+        REQUIRE(resolved.flexDirection == defaults.flexDirection);
+        REQUIRE(resolved.alignItems == defaults.alignItems);
+        REQUIRE(resolved.borderLeftColor == defaults.borderLeftColor);
+        REQUIRE(resolved.backgroundColor == 0x00000000);
+        REQUIRE(resolved.hasOpacity == defaults.hasOpacity);
+        REQUIRE(std::isnan(resolved.border));
+        REQUIRE(!resolved.clips());
+    }
+
+    SECTION("with layout strings as yoga enums") {
+        style->set(overflow, "hidden");
+        style->set(flexDirection, "rowReverse");
+        style->set(justifyContent, "spaceBetween");
+        style->set(position, "absolute");
+        resolved.resolve(*style);
+        REQUIRE(resolved.overflow == YGOverflowHidden);
+        REQUIRE(resolved.clips());
+        REQUIRE(resolved.flexDirection == YGFlexDirectionRowReverse);
+        REQUIRE(resolved.justifyContent == YGJustifySpaceBetween);
+        REQUIRE(resolved.position == YGPositionTypeAbsolute);
+    }
+
+    SECTION("with only hidden and scroll overflows clipping") {
+        style->set(overflow, "");
+        resolved.resolve(*style);
+        REQUIRE(resolved.overflow == YGOverflowVisible);
+        REQUIRE(!resolved.clips());
+
+        style->set(overflow, "clip");
+        resolved.resolve(*style);
+        REQUIRE(resolved.overflow == YGOverflowVisible);
+        REQUIRE(!resolved.clips());
+
+        style->set(overflow, "Visible");
+        resolved.resolve(*style);
+        REQUIRE(!resolved.clips());
+
+        style->set(overflow, "Scroll");
+        resolved.resolve(*style);
+        REQUIRE(resolved.overflow == YGOverflowScroll);
+        REQUIRE(resolved.clips());
+    }
+
+    SECTION("with border colors falling back") {
+        style->set(borderColor, 0xFFFF0000);
+        style->set(borderHorizontalColor, 0xFF00FF00);
+        style->set(borderLeftColor, 0xFF0000FF);
+        resolved.resolve(*style);
+        REQUIRE(resolved.borderLeftColor == 0xFF0000FF);
+        REQUIRE(resolved.borderRightColor == 0xFF00FF00);
+        REQUIRE(resolved.borderTopColor == 0xFFFF0000);
+        REQUIRE(resolved.borderBottomColor == 0xFFFF0000);
+    }
+
+    SECTION("with opacity as an alpha") {
+        style->set(opacity, 0.5f);
+        resolved.resolve(*style);
+        REQUIRE(resolved.hasOpacity);
+        REQUIRE(resolved.alpha == 127);
+    }
+
+    SECTION("on divs when their style is computed") {
+        auto styleManager = std::make_shared<StyleManager>();
+        styleManager->style(".scroller")->set(overflow, "scroll");
+        auto div = std::make_shared<Div>();
+        div->setStyleManager(styleManager);
+        div->addClassName("scroller");
+        div->updateStyle();
+        REQUIRE(div->resolvedStyle().overflow == YGOverflowScroll);
+        div->removeClassName("scroller");
+        div->updateStyle();
+        REQUIRE(div->resolvedStyle().overflow == YGOverflowVisible);
+    }
+}
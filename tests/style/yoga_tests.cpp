@@ -1,6 +1,7 @@
 #include "catch2/catch.hpp"
 #include <iostream>
 #include <yoga/Yoga.h>
+#include <psychic-ui/utils/YogaNodePool.hpp>
 
 TEST_CASE( "Making sure yoga does what we want" ) {
     YGConfigSetUseWebDefaults(YGConfigGetDefault(), true);
@@ -51,3 +52,25 @@ TEST_CASE( "Making sure yoga does what we want" ) {
 
     YGNodeFreeRecursive(container);
 }
+
+TEST_CASE( "Recycling yoga nodes" ) {
+    auto fresh  = YGNodeNew();
+    auto parent = psychic_ui::YogaNodePool::acquire();
+    auto child  = psychic_ui::YogaNodePool::acquire();
+    YGNodeInsertChild(parent, child, 0);
+    YGNodeStyleSetWidth(parent, 100);
+    YGNodeStyleSetMargin(parent, YGEdgeAll, 10);
+
+    // Parents go first, their children are detached
+    psychic_ui::YogaNodePool::release(parent);
+    psychic_ui::YogaNodePool::release(child);
+
+    auto recycled = psychic_ui::YogaNodePool::acquire();
+    REQUIRE((recycled == child || recycled == parent));
+    REQUIRE(YGNodeGetChildCount(recycled) == 0);
+    REQUIRE(YGNodeStyleGetWidth(recycled).unit == YGNodeStyleGetWidth(fresh).unit);
+    REQUIRE(YGNodeStyleGetMargin(recycled, YGEdgeLeft).unit == YGNodeStyleGetMargin(fresh, YGEdgeLeft).unit);
+
+    psychic_ui::YogaNodePool::release(recycled);
+    YGNodeFree(fresh);
+}
@@ -0,0 +1,71 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include "catch2/catch.hpp"
+#include <psychic-ui/utils/Atom.hpp>
+#include <psychic-ui/Div.hpp>
+
+using namespace psychic_ui;
+
+TEST_CASE("Atoms", "[atom]") {
+
+    SECTION("are the same for equal strings") {
+        REQUIRE(Atom("button") == Atom(std::string("button")));
+        REQUIRE(Atom("button") != Atom("label"));
+        REQUIRE(Atom("button").str() == "button");
+    }
+
+    SECTION("are empty for the empty string") {
+        REQUIRE(Atom().empty());
+        REQUIRE(Atom("").empty());
+        REQUIRE(Atom().str().empty());
+        REQUIRE(!Atom("div").empty());
+    }
+
+    SECTION("can be created from multiple threads") {
+        std::vector<std::thread> threads;
+        std::vector<unsigned int> ids(4);
+        for (unsigned int i = 0; i < ids.size(); ++i) {
+            threads.emplace_back(
+                [i, &ids]() {
+                    for (int j = 0; j < 100; ++j) {
+                        Atom("atom-test-" + std::to_string(j));
+                    }
+                    ids[i] = Atom("atom-test-shared").id();
+                }
+            );
+        }
+        for (auto &thread: threads) {
+            thread.join();
+        }
+        for (const auto id: ids) {
+            REQUIRE(id == Atom("atom-test-shared").id());
+        }
+    }
+}
+
+TEST_CASE("Div class names", "[atom]") {
+    auto div = std::make_shared<Div>();
+
+    SECTION("are lowercased and kept unique") {
+        div->addClassName("Selected");
+        div->addClassName("selected");
+        REQUIRE(div->classNames().size() == 1);
+        REQUIRE(div->hasClassName("selected"));
+    }
+
+    SECTION("can be set and removed") {
+        div->setClassNames({"One", "two"});
+        REQUIRE(div->hasClassName("one"));
+        REQUIRE(div->hasClassName("two"));
+        div->removeClassName("ONE");
+        REQUIRE(!div->hasClassName("one"));
+        REQUIRE(div->classNames().size() == 1);
+    }
+
+    SECTION("ids are lowercased") {
+        div->setId("Main");
+        REQUIRE(div->id() == "main");
+        REQUIRE(div->idAtom() == Atom("main"));
+    }
+}
@@ -0,0 +1,49 @@
+#include "catch2/catch.hpp"
+#include <psychic-ui/utils/ExtentTree.hpp>
+
+using namespace psychic_ui;
+
+TEST_CASE("Extent trees", "[virtualization]") {
+    ExtentTree tree;
+    tree.reset(100, 10);
+
+    SECTION("start with the same extent for every item") {
+        REQUIRE(tree.size() == 100);
+        REQUIRE(tree.extent(42) == 10);
+        REQUIRE(tree.offset(0) == 0);
+        REQUIRE(tree.offset(42) == 420);
+        REQUIRE(tree.total() == 1000);
+    }
+
+    SECTION("find the item at an offset") {
+        REQUIRE(tree.indexAt(-5) == 0);
+        REQUIRE(tree.indexAt(0) == 0);
+        REQUIRE(tree.indexAt(9) == 0);
+        REQUIRE(tree.indexAt(10) == 1);
+        REQUIRE(tree.indexAt(999) == 99);
+        REQUIRE(tree.indexAt(1000) == 100);
+    }
+
+    SECTION("move the following items when an extent changes") {
+        REQUIRE(tree.setExtent(10, 50));
+        REQUIRE_FALSE(tree.setExtent(10, 50));
+        REQUIRE(tree.offset(10) == 100);
+        REQUIRE(tree.offset(11) == 150);
+        REQUIRE(tree.total() == 1040);
+        REQUIRE(tree.indexAt(149) == 10);
+        REQUIRE(tree.indexAt(150) == 11);
+    }
+
+    SECTION("skip empty items") {
+        tree.setExtent(1, 0);
+        REQUIRE(tree.offset(2) == 10);
+        REQUIRE(tree.indexAt(10) == 2);
+    }
+
+    SECTION("be emptied") {
+        tree.reset(0, 10);
+        REQUIRE(tree.empty());
+        REQUIRE(tree.total() == 0);
+        REQUIRE(tree.indexAt(0) == 0);
+    }
+}
@@ -0,0 +1,71 @@
+#include "catch2/catch.hpp"
+#include <SkSurface.h>
+#include <psychic-ui/utils/LayerCache.hpp>
+
+using namespace psychic_ui;
+
+namespace {
+    sk_sp<SkImage> makeLayer(int width, int height) {
+        return SkSurface::MakeRasterN32Premul(width, height)->makeImageSnapshot();
+    }
+}
+
+TEST_CASE("Layer caches", "[layers]") {
+    // Room for 3 layers of 10x10
+    LayerCache cache{3 * 10 * 10 * 4};
+    int        a = 0, b = 0, c = 0, d = 0;
+
+    SECTION("find inserted layers") {
+        auto image = makeLayer(10, 10);
+        REQUIRE(cache.insert(&a, image));
+        REQUIRE(cache.find(&a) == image);
+        REQUIRE(cache.find(&b) == nullptr);
+        REQUIRE(cache.count() == 1);
+        REQUIRE(cache.bytes() == 400);
+    }
+
+    SECTION("replace the layer of an owner") {
+        cache.insert(&a, makeLayer(10, 10));
+        auto image = makeLayer(5, 5);
+        cache.insert(&a, image);
+        REQUIRE(cache.find(&a) == image);
+        REQUIRE(cache.count() == 1);
+        REQUIRE(cache.bytes() == 100);
+    }
+
+    SECTION("evict the least recently used layers") {
+        cache.insert(&a, makeLayer(10, 10));
+        cache.insert(&b, makeLayer(10, 10));
+        cache.insert(&c, makeLayer(10, 10));
+        // a is now more recent than b
+        REQUIRE(cache.find(&a) != nullptr);
+        cache.insert(&d, makeLayer(10, 10));
+        REQUIRE(cache.count() == 3);
+        REQUIRE(cache.find(&b) == nullptr);
+        REQUIRE(cache.find(&a) != nullptr);
+        REQUIRE(cache.find(&c) != nullptr);
+        REQUIRE(cache.find(&d) != nullptr);
+    }
+
+    SECTION("refuse layers larger than the budget") {
+        REQUIRE_FALSE(cache.insert(&a, makeLayer(100, 100)));
+        REQUIRE(cache.find(&a) == nullptr);
+        REQUIRE(cache.bytes() == 0);
+    }
+
+    SECTION("evict when the budget shrinks") {
+        cache.insert(&a, makeLayer(10, 10));
+        cache.insert(&b, makeLayer(10, 10));
+        cache.setBudget(400);
+        REQUIRE(cache.count() == 1);
+        REQUIRE(cache.find(&b) != nullptr);
+    }
+
+    SECTION("remove layers") {
+        cache.insert(&a, makeLayer(10, 10));
+        cache.remove(&a);
+        cache.remove(&b);
+        REQUIRE(cache.find(&a) == nullptr);
+        REQUIRE(cache.bytes() == 0);
+    }
+}
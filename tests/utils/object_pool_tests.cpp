@@ -0,0 +1,62 @@
+#include "catch2/catch.hpp"
+#include <cstdint>
+#include <memory>
+#include <psychic-ui/utils/ObjectPool.hpp>
+
+using namespace psychic_ui;
+
+namespace {
+    struct Pooled {
+        explicit Pooled(int value) : value(value) {}
+        int  value;
+        char padding[100]{};
+    };
+}
+
+TEST_CASE("Object pools", "[memory]") {
+
+    SECTION("reuse freed blocks") {
+        void *block = ObjectPool::allocate(40);
+        REQUIRE(block != nullptr);
+        ObjectPool::deallocate(block, 40);
+        // Same size class
+        void *again = ObjectPool::allocate(48);
+        REQUIRE(again == block);
+        ObjectPool::deallocate(again, 48);
+    }
+
+    SECTION("align blocks") {
+        void *a = ObjectPool::allocate(1);
+        void *b = ObjectPool::allocate(24);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(a) % ObjectPool::granularity == 0);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(b) % ObjectPool::granularity == 0);
+        ObjectPool::deallocate(a, 1);
+        ObjectPool::deallocate(b, 24);
+    }
+
+    SECTION("count used blocks") {
+        const auto before = ObjectPool::stats();
+        void       *block = ObjectPool::allocate(200);
+        REQUIRE(ObjectPool::stats().used == before.used + 1);
+        ObjectPool::deallocate(block, 200);
+        REQUIRE(ObjectPool::stats().used == before.used);
+    }
+
+    SECTION("forward large allocations") {
+        const auto before = ObjectPool::stats();
+        void       *block = ObjectPool::allocate(ObjectPool::maxBlockSize + 1);
+        REQUIRE(block != nullptr);
+        REQUIRE(ObjectPool::stats().used == before.used);
+        ObjectPool::deallocate(block, ObjectPool::maxBlockSize + 1);
+    }
+
+    SECTION("make shared objects") {
+        const auto before = ObjectPool::stats();
+        {
+            auto pooled = makePooled<Pooled>(42);
+            REQUIRE(pooled->value == 42);
+            REQUIRE(ObjectPool::stats().used == before.used + 1);
+        }
+        REQUIRE(ObjectPool::stats().used == before.used);
+    }
+}
@@ -0,0 +1,68 @@
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include "catch2/catch.hpp"
+#include <psychic-ui/utils/TaskPool.hpp>
+
+using namespace psychic_ui;
+
+namespace {
+    void fanOut(TaskGroup &group, std::atomic<unsigned int> &count, const unsigned int depth) {
+        ++count;
+        if (depth == 0) {
+            return;
+        }
+        for (unsigned int i = 0; i < 4; ++i) {
+            group.run([&group, &count, depth]() { fanOut(group, count, depth - 1); });
+        }
+    }
+}
+
+TEST_CASE("Task pools", "[tasks]") {
+    for (unsigned int threads : {0u, 1u, 4u}) {
+        TaskPool pool{threads};
+        REQUIRE(pool.threadCount() == threads);
+
+        SECTION("run every task of a group, " + std::to_string(threads) + " workers") {
+            std::atomic<unsigned int> count{0};
+            TaskGroup                 group{pool};
+            for (unsigned int i = 0; i < 100; ++i) {
+                group.run([&count]() { ++count; });
+            }
+            group.wait();
+            REQUIRE(count == 100);
+        }
+
+        SECTION("run tasks queued by other tasks, " + std::to_string(threads) + " workers") {
+            std::atomic<unsigned int> count{0};
+            TaskGroup                 group{pool};
+            fanOut(group, count, 4);
+            group.wait();
+            REQUIRE(count == 1 + 4 + 16 + 64 + 256);
+        }
+
+        SECTION("wait on groups from inside tasks, " + std::to_string(threads) + " workers") {
+            std::atomic<unsigned int> count{0};
+            TaskGroup                 outer{pool};
+            for (unsigned int i = 0; i < 8; ++i) {
+                outer.run(
+                    [&pool, &count]() {
+                        TaskGroup inner{pool};
+                        for (unsigned int j = 0; j < 8; ++j) {
+                            inner.run([&count]() { ++count; });
+                        }
+                        inner.wait();
+                    }
+                );
+            }
+            outer.wait();
+            REQUIRE(count == 64);
+        }
+
+        SECTION("rethrow exceptions when waiting, " + std::to_string(threads) + " workers") {
+            TaskGroup group{pool};
+            group.run([]() { throw std::runtime_error("task failed"); });
+            REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+        }
+    }
+}
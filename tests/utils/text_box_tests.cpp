@@ -0,0 +1,86 @@
+#include "catch2/catch.hpp"
+#include <algorithm>
+#include <vector>
+#include <unicode/unistr.h>
+#include <SkPaint.h>
+#include <psychic-ui/utils/TextBox.hpp>
+
+using namespace psychic_ui;
+
+namespace {
+    std::vector<unsigned int> lineStarts(const TextBox &textBox) {
+        std::vector<unsigned int> starts{};
+        for (unsigned int line = 0; line < textBox.lineCount(); ++line) {
+            starts.push_back(textBox.lineStart(line));
+        }
+        return starts;
+    }
+}
+
+TEST_CASE("Text box line breaks", "[text]") {
+    SkPaint paint{};
+    paint.setTextSize(13.0f);
+
+    icu::UnicodeString text = icu::UnicodeString::fromUTF8(
+        "Lorem ipsum dolor sit amet, consectetur adipiscing elit.\n"
+        "Sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\n"
+        "\n"
+        "Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris."
+    );
+
+    TextBox textBox{};
+    textBox.setPaint(paint);
+    textBox.setText(text);
+    textBox.setBox(0.0f, 0.0f, 120.0f, 0.0f);
+
+    SECTION("start a line after every line feed") {
+        auto starts = lineStarts(textBox);
+        REQUIRE(starts.front() == 0);
+        for (int32_t i = 0; i < text.length(); ++i) {
+            if (text.charAt(i) == '\n') {
+                REQUIRE(std::find(starts.begin(), starts.end(), static_cast<unsigned int>(i) + 1) != starts.end());
+            }
+        }
+    }
+
+    SECTION("give a final line return its own line") {
+        text.append(static_cast<UChar>('\n'));
+        textBox.updateText();
+        REQUIRE(textBox.lineStart(textBox.lineCount() - 1) == static_cast<unsigned int>(text.length()));
+    }
+
+    SECTION("break the same way after an edit as from scratch") {
+        const unsigned int edits[][3] = {
+            {10, 0, 1},  // Typing
+            {30, 5, 0},  // Erasing
+            {52, 1, 0},  // Joining two paragraphs
+            {20, 0, 1},  // Splitting a paragraph
+            {0, 3, 2},   // Replacing at the start
+        };
+        const char *inserted[] = {"x", "", "", "\n", "ab"};
+
+        for (unsigned int i = 0; i < 5; ++i) {
+            text.replace(
+                static_cast<int32_t>(edits[i][0]),
+                static_cast<int32_t>(edits[i][1]),
+                icu::UnicodeString::fromUTF8(inserted[i])
+            );
+            textBox.updateText(edits[i][0], edits[i][1], edits[i][2]);
+
+            TextBox fromScratch{};
+            fromScratch.setPaint(paint);
+            fromScratch.setText(text);
+            fromScratch.setBox(0.0f, 0.0f, 120.0f, 0.0f);
+            REQUIRE(lineStarts(textBox) == lineStarts(fromScratch));
+        }
+
+        // Appending at the very end
+        text.append(icu::UnicodeString::fromUTF8("\nend"));
+        textBox.updateText(static_cast<unsigned int>(text.length()) - 4, 0, 4);
+        TextBox fromScratch{};
+        fromScratch.setPaint(paint);
+        fromScratch.setText(text);
+        fromScratch.setBox(0.0f, 0.0f, 120.0f, 0.0f);
+        REQUIRE(lineStarts(textBox) == lineStarts(fromScratch));
+    }
+}